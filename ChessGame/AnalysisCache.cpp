@@ -0,0 +1,213 @@
+#include "AnalysisCache.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+	// The last byte is the format version; files of an older version are discarded
+	constexpr char FILE_MAGIC[8] = { 'C', 'G', 'C', 'A', 'C', 'H', 'E', '2' };
+	constexpr size_t HEADER_SIZE = sizeof(FILE_MAGIC);
+	constexpr size_t VERSION_OFFSET = HEADER_SIZE - 1;
+
+	// std::fseek takes a long, which is 32 bits on Windows
+	bool seekTo(std::FILE* file, size_t offset) {
+#if defined(_WIN32)
+		return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET) == 0;
+#else
+		return fseeko(file, static_cast<off_t>(offset), SEEK_SET) == 0;
+#endif
+	}
+}
+
+AnalysisCache::AnalysisCache(size_t memoryEntries)
+	: memoryCapacity(memoryEntries ? memoryEntries : 1), appendFile(nullptr), fileSize(0) {
+}
+
+AnalysisCache::~AnalysisCache() {
+	if (appendFile) std::fclose(appendFile);
+}
+
+/**
+ * @brief  Opens (creating if needed) the cache file at `path`, maps it and indexes its records.
+ *
+ * A trailing partial or corrupt record, left by a crash mid-append, is
+ * ignored and overwritten by the next store. Returns false if the file
+ * cannot be created or is not a cache file; the memory tier still works.
+ */
+bool AnalysisCache::open(const std::string& newPath) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (appendFile) std::fclose(appendFile);
+	appendFile = nullptr;
+	diskIndex.clear();
+	fileSize = 0;
+	path = newPath;
+
+	// "a" creates the file without truncating it
+	if (std::FILE* create = std::fopen(path.c_str(), "ab")) std::fclose(create);
+	if (!mappedFile.open(path)) return false;
+
+	bool outdated = false;
+	if (mappedFile.size() >= HEADER_SIZE && std::memcmp(mappedFile.data(), FILE_MAGIC, HEADER_SIZE) != 0) {
+		outdated = std::memcmp(mappedFile.data(), FILE_MAGIC, VERSION_OFFSET) == 0;
+		mappedFile.close();
+		if (!outdated) return false;
+	}
+
+	// An older record layout cannot be read back, so the file starts over
+	appendFile = std::fopen(path.c_str(), outdated ? "w+b" : "r+b");
+	if (!appendFile) return false;
+
+	if (outdated || mappedFile.size() < HEADER_SIZE) {
+		std::fwrite(FILE_MAGIC, 1, HEADER_SIZE, appendFile);
+		std::fflush(appendFile);
+		fileSize = HEADER_SIZE;
+	}
+	else {
+		fileSize = HEADER_SIZE;
+		indexRecords(HEADER_SIZE);
+	}
+	return true;
+}
+
+/**
+ * @brief  Adds every valid record of the mapping from byte `from` on to the disk index.
+ */
+void AnalysisCache::indexRecords(size_t from) {
+	const uint8_t* data = mappedFile.data();
+	for (size_t offset = from; offset + sizeof(DiskRecord) <= mappedFile.size(); offset += sizeof(DiskRecord)) {
+		DiskRecord record;
+		std::memcpy(&record, data + offset, sizeof(record));
+		if (record.checksum != checksum(record)) break;
+
+		CacheKey key = { record.key, record.multiPV };
+		auto it = diskIndex.find(key);
+		if (it == diskIndex.end() || record.depth >= it->second.depth) diskIndex[key] = { offset, record.depth };
+		fileSize = offset + sizeof(DiskRecord);
+	}
+}
+
+/**
+ * @brief  Finds an analysis of `key` with `multiPV` lines searched to at least `minDepth`.
+ */
+bool AnalysisCache::lookup(uint64_t key, int multiPV, int minDepth, UciAnalysis& analysis) {
+	std::lock_guard<std::mutex> lock(mutex);
+	if (multiPV < 1 || multiPV > MAX_LINES) {
+		++stats.misses;
+		return false;
+	}
+	CacheKey cacheKey = { key, multiPV };
+
+	auto memoryIt = memoryIndex.find(cacheKey);
+	if (memoryIt != memoryIndex.end() && memoryIt->second->analysis.depth >= minDepth) {
+		lru.splice(lru.begin(), lru, memoryIt->second);
+		analysis = memoryIt->second->analysis;
+		++stats.memoryHits;
+		return true;
+	}
+
+	auto diskIt = diskIndex.find(cacheKey);
+	if (diskIt != diskIndex.end() && diskIt->second.depth >= minDepth) {
+		// Records appended since the file was mapped need a fresh mapping
+		if (diskIt->second.offset + sizeof(DiskRecord) > mappedFile.size()) mappedFile.open(path);
+		if (diskIt->second.offset + sizeof(DiskRecord) <= mappedFile.size()) {
+			DiskRecord record;
+			std::memcpy(&record, mappedFile.data() + diskIt->second.offset, sizeof(record));
+			analysis = decode(record);
+			remember(cacheKey, analysis);
+			++stats.diskHits;
+			return true;
+		}
+	}
+
+	++stats.misses;
+	return false;
+}
+
+/**
+ * @brief  Caches a completed analysis in memory and appends it to the file.
+ */
+void AnalysisCache::store(uint64_t key, int multiPV, const UciAnalysis& analysis) {
+	// A record holds at most MAX_LINES lines, and multiPV must fit its byte
+	if (!analysis.completed || analysis.lines.empty() || multiPV < 1 || multiPV > MAX_LINES) return;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	CacheKey cacheKey = { key, multiPV };
+	remember(cacheKey, analysis);
+	++stats.stores;
+
+	if (!appendFile) return;
+	DiskRecord record = encode(key, multiPV, analysis);
+	if (!seekTo(appendFile, fileSize)) return;
+	if (std::fwrite(&record, sizeof(record), 1, appendFile) != 1) return;
+	std::fflush(appendFile);
+
+	auto it = diskIndex.find(cacheKey);
+	if (it == diskIndex.end() || record.depth >= it->second.depth) diskIndex[cacheKey] = { fileSize, record.depth };
+	fileSize += sizeof(record);
+}
+
+/**
+ * @brief  Inserts or refreshes an entry at the front of the LRU list, evicting from the back.
+ */
+void AnalysisCache::remember(const CacheKey& key, const UciAnalysis& analysis) {
+	auto it = memoryIndex.find(key);
+	if (it != memoryIndex.end()) {
+		if (analysis.depth < it->second->analysis.depth) return;
+		it->second->analysis = analysis;
+		lru.splice(lru.begin(), lru, it->second);
+		return;
+	}
+
+	if (lru.size() >= memoryCapacity) {
+		memoryIndex.erase(lru.back().key);
+		lru.pop_back();
+	}
+	lru.push_front({ key, analysis });
+	memoryIndex[key] = lru.begin();
+}
+
+/**
+ * @brief  FNV-1a over the record with the checksum field zeroed.
+ */
+uint32_t AnalysisCache::checksum(const DiskRecord& record) {
+	DiskRecord copy = record;
+	copy.checksum = 0;
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&copy);
+	uint32_t hash = 2166136261u;
+	for (size_t i = 0; i < sizeof(copy); ++i) hash = (hash ^ bytes[i]) * 16777619u;
+	return hash;
+}
+
+AnalysisCache::DiskRecord AnalysisCache::encode(uint64_t key, int multiPV, const UciAnalysis& analysis) {
+	DiskRecord record;
+	std::memset(&record, 0, sizeof(record));
+	record.key = key;
+	record.multiPV = static_cast<uint8_t>(multiPV);
+	record.depth = static_cast<uint8_t>(std::min(analysis.depth, 255));
+	record.lineCount = static_cast<uint8_t>(std::min<size_t>(analysis.lines.size(), MAX_LINES));
+	std::memcpy(record.ponderMove, analysis.ponderMove.data(), std::min(analysis.ponderMove.size(), sizeof(record.ponderMove)));
+	for (int i = 0; i < record.lineCount; ++i) {
+		const UciLine& line = analysis.lines[i];
+		std::memcpy(record.lines[i].move, line.move.data(), std::min<size_t>(line.move.size(), sizeof(record.lines[i].move)));
+		record.lines[i].isMate = line.isMate;
+		record.lines[i].score = line.score;
+	}
+	record.checksum = checksum(record);
+	return record;
+}
+
+UciAnalysis AnalysisCache::decode(const DiskRecord& record) {
+	UciAnalysis analysis;
+	analysis.depth = record.depth;
+	analysis.completed = true;
+	analysis.ponderMove.assign(record.ponderMove, std::find(record.ponderMove, record.ponderMove + sizeof(record.ponderMove), '\0'));
+	for (int i = 0; i < std::min<int>(record.lineCount, MAX_LINES); ++i) {
+		const DiskLine& diskLine = record.lines[i];
+		UciLine line;
+		line.move.assign(diskLine.move, std::find(diskLine.move, diskLine.move + sizeof(diskLine.move), '\0'));
+		line.isMate = diskLine.isMate != 0;
+		line.score = diskLine.score;
+		analysis.lines.push_back(line);
+	}
+	return analysis;
+}
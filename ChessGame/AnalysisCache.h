@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "MappedFile.h"
+#include "Stockfish.h"
+
+/**
+ * @brief  Cache of engine analyses keyed by Zobrist key and MultiPV count.
+ *
+ * Two tiers: a bounded LRU list in memory, and an append-only file of
+ * fixed-size records that is memory-mapped when opened. Only an index of
+ * file offsets is built at startup; a record is decoded the first time it is
+ * looked up and then promoted to the memory tier. Every store is appended to
+ * the file, so the newest, deepest result for a position wins on reload.
+ *
+ * Entries are keyed by position and MultiPV count only; the limits that
+ * produced a result (movetime, clock, nodes) are not recorded. Depth is the
+ * measure of quality instead: a lookup hits when the cached search reached
+ * at least the requested depth, however it was limited, so callers ask for
+ * the depth a fresh search would be expected to reach.
+ *
+ * A record holds up to MAX_LINES lines; analyses with a larger MultiPV
+ * count are neither stored nor looked up.
+ */
+class AnalysisCache {
+public:
+	static constexpr int MAX_LINES = 8;
+
+	struct Stats {
+		uint64_t memoryHits = 0;
+		uint64_t diskHits = 0;
+		uint64_t misses = 0;
+		uint64_t stores = 0;
+	};
+
+	explicit AnalysisCache(size_t memoryEntries = 4096);
+	~AnalysisCache();
+
+	bool open(const std::string& path);
+
+	bool lookup(uint64_t key, int multiPV, int minDepth, UciAnalysis& analysis);
+	void store(uint64_t key, int multiPV, const UciAnalysis& analysis);
+
+	size_t diskRecordCount() const {
+		return diskIndex.size();
+	}
+	const Stats& getStats() const {
+		return stats;
+	}
+
+private:
+#pragma pack(push, 1)
+	struct DiskLine {
+		char move[6];       // UCI move, NUL-padded
+		uint8_t isMate;
+		uint8_t reserved;
+		int32_t score;
+	};
+
+	// Little-endian on disk; every field is naturally aligned within the record
+	struct DiskRecord {
+		uint64_t key;
+		uint8_t multiPV;
+		uint8_t depth;
+		uint8_t lineCount;
+		uint8_t reserved;
+		uint32_t checksum;  // Detects a record torn by a crash mid-append
+		char ponderMove[6]; // UCI move, NUL-padded; empty if the engine gave none
+		uint8_t reserved2[2];
+		DiskLine lines[MAX_LINES];
+	};
+#pragma pack(pop)
+
+	struct CacheKey {
+		uint64_t key;
+		int multiPV;
+
+		bool operator==(const CacheKey& other) const {
+			return key == other.key && multiPV == other.multiPV;
+		}
+	};
+
+	struct CacheKeyHash {
+		size_t operator()(const CacheKey& cacheKey) const {
+			return static_cast<size_t>(cacheKey.key ^ (static_cast<uint64_t>(cacheKey.multiPV) * 0x9E3779B97F4A7C15ULL));
+		}
+	};
+
+	struct MemoryEntry {
+		CacheKey key;
+		UciAnalysis analysis;
+	};
+
+	struct DiskEntry {
+		size_t offset;
+		int depth;
+	};
+
+	static uint32_t checksum(const DiskRecord& record);
+	static DiskRecord encode(uint64_t key, int multiPV, const UciAnalysis& analysis);
+	static UciAnalysis decode(const DiskRecord& record);
+
+	void indexRecords(size_t from);
+	void remember(const CacheKey& key, const UciAnalysis& analysis);
+
+	size_t memoryCapacity;
+	std::list<MemoryEntry> lru;  // Most recently used first
+	std::unordered_map<CacheKey, std::list<MemoryEntry>::iterator, CacheKeyHash> memoryIndex;
+
+	std::string path;
+	MappedFile mappedFile;
+	std::FILE* appendFile;
+	size_t fileSize;            // Bytes of whole records, mapped or appended since
+	std::unordered_map<CacheKey, DiskEntry, CacheKeyHash> diskIndex;
+
+	std::mutex mutex;
+	Stats stats;
+};
@@ -0,0 +1,145 @@
+#include "Bitboard.h"
+
+namespace Bitboards {
+	Bitboard knightAttacks[SQUARE_NB];
+	Bitboard kingAttacks[SQUARE_NB];
+	Bitboard pawnAttacks[2][SQUARE_NB];
+	Bitboard between[SQUARE_NB][SQUARE_NB];
+	Bitboard line[SQUARE_NB][SQUARE_NB];
+
+	Magic rookMagics[SQUARE_NB];
+	Magic bishopMagics[SQUARE_NB];
+}
+
+namespace {
+	Bitboard rookTable[0x19000];   // 102400 entries, the sum of 2^bits over all squares
+	Bitboard bishopTable[0x1480];  // 5248 entries
+
+	const Square ROOK_DIRECTIONS[] = { {0, 1}, {0, -1}, {1, 0}, {-1, 0} };
+	const Square BISHOP_DIRECTIONS[] = { {1, 1}, {-1, -1}, {1, -1}, {-1, 1} };
+
+	bool isOnBoard(Square square) {
+		return square.row >= 0 && square.row < 8 && square.col >= 0 && square.col < 8;
+	}
+
+	/**
+	 * @brief  Walks every ray from a square, stopping at (and including) the first blocker.
+	 *
+	 * Only used while building the tables, so speed does not matter here.
+	 */
+	Bitboard slidingAttacks(const Square* directions, int square, Bitboard occupied) {
+		Bitboard attacks = 0;
+		for (int i = 0; i < 4; ++i) {
+			Square current = indexToSquare(square);
+			while (true) {
+				current += directions[i];
+				if (!isOnBoard(current)) break;
+				attacks |= squareBB(squareIndex(current));
+				if (occupied & squareBB(squareIndex(current))) break;
+			}
+		}
+		return attacks;
+	}
+
+	Bitboard stepAttacks(int square, const Square* offsets, int count) {
+		Bitboard attacks = 0;
+		for (int i = 0; i < count; ++i) {
+			Square target = indexToSquare(square) + offsets[i];
+			if (isOnBoard(target)) attacks |= squareBB(squareIndex(target));
+		}
+		return attacks;
+	}
+
+	/**
+	 * @brief  Finds a magic multiplier for every square and fills the shared attack table.
+	 *
+	 * The relevant-occupancy mask excludes board edges because a blocker on the
+	 * edge never changes the attack set. Each subset of the mask is enumerated
+	 * with the Carry-Rippler trick and the multiplier is accepted once it maps
+	 * every subset to a slot without a destructive collision.
+	 */
+	void initMagics(Bitboards::Magic* magics, Bitboard* table, const Square* directions) {
+		static Bitboard occupancies[4096], references[4096];
+		static int epoch[4096];
+		static int currentEpoch = 0;
+		Prng prng(0x2545F4914F6CDD1DULL);
+		Bitboard* nextSlot = table;
+
+		for (int square = 0; square < SQUARE_NB; ++square) {
+			int row = rowOf(square), col = colOf(square);
+			Bitboard edges = ((rowBB(0) | rowBB(7)) & ~rowBB(row)) | ((FILE_A_BB | FILE_H_BB) & ~(FILE_A_BB << col));
+
+			Bitboards::Magic& m = magics[square];
+			m.mask = slidingAttacks(directions, square, 0) & ~edges;
+			m.shift = 64 - popCount(m.mask);
+			m.attacks = nextSlot;
+
+			int size = 0;
+			Bitboard subset = 0;
+			do {
+				occupancies[size] = subset;
+				references[size] = slidingAttacks(directions, square, subset);
+				++size;
+				subset = (subset - m.mask) & m.mask;
+			} while (subset);
+
+			for (int i = 0; i < size; ) {
+				do {
+					m.magic = prng.sparse();
+				} while (popCount((m.magic * m.mask) >> 56) < 6);
+
+				++currentEpoch;
+				for (i = 0; i < size; ++i) {
+					unsigned idx = m.index(occupancies[i]);
+					if (epoch[idx] < currentEpoch) {
+						epoch[idx] = currentEpoch;
+						m.attacks[idx] = references[i];
+					}
+					else if (m.attacks[idx] != references[i]) {
+						break;
+					}
+				}
+			}
+			nextSlot += size;
+		}
+	}
+}
+
+/**
+ * @brief  Precomputes leaper, pawn, slider and line tables.
+ *
+ * Must run once before any Position is used; Position's constructor takes care of it.
+ */
+void Bitboards::init() {
+	const Square knightOffsets[] = { {2, 1}, {2, -1}, {1, 2}, {1, -2}, {-1, 2}, {-1, -2}, {-2, 1}, {-2, -1} };
+	const Square kingOffsets[] = { {1, 1}, {-1, -1}, {1, -1}, {-1, 1}, {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+	const Square whitePawnOffsets[] = { {-1, -1}, {-1, 1} }; // White moves up (-1)
+	const Square blackPawnOffsets[] = { {1, -1}, {1, 1} };
+
+	for (int square = 0; square < SQUARE_NB; ++square) {
+		knightAttacks[square] = stepAttacks(square, knightOffsets, 8);
+		kingAttacks[square] = stepAttacks(square, kingOffsets, 8);
+		pawnAttacks[static_cast<int>(Color::WHITE)][square] = stepAttacks(square, whitePawnOffsets, 2);
+		pawnAttacks[static_cast<int>(Color::BLACK)][square] = stepAttacks(square, blackPawnOffsets, 2);
+	}
+
+	initMagics(rookMagics, rookTable, ROOK_DIRECTIONS);
+	initMagics(bishopMagics, bishopTable, BISHOP_DIRECTIONS);
+
+	for (int from = 0; from < SQUARE_NB; ++from) {
+		for (int to = 0; to < SQUARE_NB; ++to) {
+			between[from][to] = line[from][to] = 0;
+			if (from == to) continue;
+
+			Bitboard toBB = squareBB(to);
+			if (rookAttacks(from, 0) & toBB) {
+				between[from][to] = rookAttacks(from, toBB) & rookAttacks(to, squareBB(from));
+				line[from][to] = (rookAttacks(from, 0) & rookAttacks(to, 0)) | squareBB(from) | toBB;
+			}
+			else if (bishopAttacks(from, 0) & toBB) {
+				between[from][to] = bishopAttacks(from, toBB) & bishopAttacks(to, squareBB(from));
+				line[from][to] = (bishopAttacks(from, 0) & bishopAttacks(to, 0)) | squareBB(from) | toBB;
+			}
+		}
+	}
+}
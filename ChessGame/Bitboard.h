@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#include "Types.h"
+
+using Bitboard = uint64_t;
+
+/*
+ * Squares are indexed 0..63 in the same orientation as ChessBoard's board array:
+ * index = row * 8 + col, so a8 is 0 and h1 is 63.
+ */
+constexpr int SQUARE_NB = 64;
+constexpr int NO_SQUARE = -1;
+
+constexpr Bitboard FILE_A_BB = 0x0101010101010101ULL;
+constexpr Bitboard FILE_H_BB = FILE_A_BB << 7;
+constexpr Bitboard ROW_0_BB = 0xFFULL;          // Rank 8
+constexpr Bitboard ROW_7_BB = ROW_0_BB << 56;   // Rank 1
+constexpr Bitboard LIGHT_SQUARES_BB = 0xAA55AA55AA55AA55ULL;  // a8, c8, ..., h1
+
+constexpr int squareIndex(int row, int col) {
+	return row * 8 + col;
+}
+
+constexpr int squareIndex(Square square) {
+	return square.row * 8 + square.col;
+}
+
+constexpr Square indexToSquare(int index) {
+	return { index >> 3, index & 7 };
+}
+
+constexpr int rowOf(int index) {
+	return index >> 3;
+}
+
+constexpr int colOf(int index) {
+	return index & 7;
+}
+
+constexpr Bitboard squareBB(int index) {
+	return 1ULL << index;
+}
+
+constexpr Bitboard rowBB(int row) {
+	return ROW_0_BB << (8 * row);
+}
+
+inline int popCount(Bitboard b) {
+#if defined(_MSC_VER)
+	return static_cast<int>(__popcnt64(b));
+#else
+	return __builtin_popcountll(b);
+#endif
+}
+
+/**
+ * @brief  Index of the least significant set bit. The bitboard must not be empty.
+ */
+inline int lsb(Bitboard b) {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64(&index, b);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctzll(b);
+#endif
+}
+
+inline int popLsb(Bitboard& b) {
+	int index = lsb(b);
+	b &= b - 1;
+	return index;
+}
+
+constexpr bool moreThanOne(Bitboard b) {
+	return (b & (b - 1)) != 0;
+}
+
+/**
+ * @brief  xorshift64* generator. Seeded explicitly so every table built from it is reproducible.
+ */
+class Prng {
+public:
+	explicit Prng(uint64_t seed) : state(seed) {}
+
+	uint64_t next() {
+		state ^= state >> 12;
+		state ^= state << 25;
+		state ^= state >> 27;
+		return state * 2685821657736338717ULL;
+	}
+
+	// Magics work best with few set bits
+	uint64_t sparse() {
+		return next() & next() & next();
+	}
+
+private:
+	uint64_t state;
+};
+
+namespace Bitboards {
+	void init();
+
+	extern Bitboard knightAttacks[SQUARE_NB];
+	extern Bitboard kingAttacks[SQUARE_NB];
+	extern Bitboard pawnAttacks[2][SQUARE_NB];
+	extern Bitboard between[SQUARE_NB][SQUARE_NB];
+	extern Bitboard line[SQUARE_NB][SQUARE_NB];
+
+	struct Magic {
+		Bitboard mask;
+		Bitboard magic;
+		Bitboard* attacks;
+		unsigned shift;
+
+		unsigned index(Bitboard occupied) const {
+			return static_cast<unsigned>(((occupied & mask) * magic) >> shift);
+		}
+	};
+
+	extern Magic rookMagics[SQUARE_NB];
+	extern Magic bishopMagics[SQUARE_NB];
+
+	inline Bitboard rookAttacks(int square, Bitboard occupied) {
+		const Magic& m = rookMagics[square];
+		return m.attacks[m.index(occupied)];
+	}
+
+	inline Bitboard bishopAttacks(int square, Bitboard occupied) {
+		const Magic& m = bishopMagics[square];
+		return m.attacks[m.index(occupied)];
+	}
+
+	inline Bitboard queenAttacks(int square, Bitboard occupied) {
+		return rookAttacks(square, occupied) | bishopAttacks(square, occupied);
+	}
+}
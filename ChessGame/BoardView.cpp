@@ -0,0 +1,123 @@
+#include "BoardView.h"
+
+#include <iostream>
+#include <string>
+
+/**
+ * @brief  Loads the font and textures and renders the board background.
+ *
+ * The squares and their labels are drawn once into a texture so each frame
+ * only has to blit it.
+ */
+BoardView::BoardView() : boardTexture(sf::Vector2u(WINDOW_SIZE, WINDOW_SIZE)), boardSprite(boardTexture.getTexture()) {
+
+	if (!font.openFromFile("fonts/arial.ttf")) {
+		std::cerr << "Failed to load font!" << std::endl;
+		return;
+	}
+
+	if (!loadTextures()) {
+		std::cerr << "Error loading textures!" << std::endl;
+	}
+
+	sf::Text label(font);
+
+	for (int row = 0; row < BOARD_SIZE; ++row) {
+		for (int col = 0; col < BOARD_SIZE; ++col) {
+			// Draw the chessboard squares
+			sf::RectangleShape square({ SQUARE_SIZE, SQUARE_SIZE });
+			square.setPosition({ col * SQUARE_SIZE, row * SQUARE_SIZE });
+			square.setFillColor((row + col) % 2 == 0 ? sf::Color::White : sf::Color(118, 150, 86));
+			boardTexture.draw(square);
+
+			// Determine text color to contrast the square color
+			sf::Color textColor = (row + col) % 2 == 0 ? sf::Color(118, 150, 86) : sf::Color::White;
+
+			// Draw column labels (a-h) at the bottom
+			if (row == BOARD_SIZE - 1) {
+				label.setString(static_cast<char>('a' + col));
+				label.setPosition({ (col + 1) * SQUARE_SIZE - 22 ,  (row + 1) * SQUARE_SIZE - 35 });
+				label.setFillColor(textColor);
+				boardTexture.draw(label);
+			}
+
+			// Draw row labels (1-8) on the left side
+			if (col == 0) {
+				label.setString(std::to_string(8 - row));
+				label.setPosition({ col * SQUARE_SIZE + 5, row * SQUARE_SIZE + 5 });
+				label.setFillColor(textColor);
+				boardTexture.draw(label);
+			}
+		}
+	}
+	boardTexture.display();
+	boardSprite.setTexture(boardTexture.getTexture());
+}
+
+/**
+ * @brief  Loads all piece textures once to improve performance.
+ *
+ * Reduces disk I/O by caching textures in memory, ensuring smooth rendering.
+ */
+bool BoardView::loadTextures() {
+	std::map<PieceType, std::string> textureFiles = {
+		{PieceType::W_PAWN, "pieces-png/wp.png"}, {PieceType::B_PAWN, "pieces-png/bp.png"},
+		{PieceType::W_ROOK, "pieces-png/wr.png"}, {PieceType::B_ROOK, "pieces-png/br.png"},
+		{PieceType::W_KNIGHT, "pieces-png/wn.png"}, {PieceType::B_KNIGHT, "pieces-png/bn.png"},
+		{PieceType::W_BISHOP, "pieces-png/wb.png"}, {PieceType::B_BISHOP, "pieces-png/bb.png"},
+		{PieceType::W_QUEEN, "pieces-png/wq.png"}, {PieceType::B_QUEEN, "pieces-png/bq.png"},
+		{PieceType::W_KING, "pieces-png/wk.png"}, {PieceType::B_KING, "pieces-png/bk.png"}
+	};
+
+	for (const auto& [piece, file] : textureFiles) {
+		if (!pieceTextures[piece].loadFromFile(file)) {
+			std::cerr << "Failed to load texture: " << file << std::endl;
+			return false;
+		}
+		pieceTextures[piece].setSmooth(true); // Anti-aliasing for better visuals
+	}
+	return true;
+}
+
+/**
+ * @brief  Renders the chessboard and all pieces.
+ *
+ * Pieces of the side to move that the opponent can win by capturing are
+ * marked with a red square beneath them. The dragged piece is drawn last,
+ * at `dragPosition` instead of its square, so it stays on top while it
+ * follows the mouse.
+ */
+void BoardView::draw(sf::RenderWindow& window, const ChessBoard& board, const Piece* draggedPiece, sf::Vector2f dragPosition) const {
+	window.draw(boardSprite);
+
+	Bitboard hanging = board.hangingPieces();
+	while (hanging) {
+		sf::RectangleShape highlight({ SQUARE_SIZE, SQUARE_SIZE });
+		int square = popLsb(hanging);
+		highlight.setPosition(squareToPixels({ rowOf(square), colOf(square) }));
+		highlight.setFillColor(sf::Color(220, 40, 40, 110));
+		window.draw(highlight);
+	}
+
+	for (int row = 0; row < BOARD_SIZE; ++row) {
+		for (int col = 0; col < BOARD_SIZE; ++col) {
+			const Piece* piece = board.getPiece({ row, col });
+			if (piece && piece != draggedPiece) {
+				drawPiece(window, piece->getType(), squareToPixels(piece->getSquare()));
+			}
+		}
+	}
+	if (draggedPiece) {
+		drawPiece(window, draggedPiece->getType(), dragPosition);
+	}
+}
+
+void BoardView::drawPiece(sf::RenderWindow& window, PieceType type, sf::Vector2f position) const {
+	auto texture = pieceTextures.find(type);
+	if (texture == pieceTextures.end()) return;
+
+	sf::Sprite sprite(texture->second);
+	sprite.setScale(sf::Vector2f(SQUARE_SIZE / texture->second.getSize().x, SQUARE_SIZE / texture->second.getSize().y));
+	sprite.setPosition(position);
+	window.draw(sprite);
+}
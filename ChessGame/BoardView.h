@@ -0,0 +1,34 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <map>
+
+#include "ChessBoard.h"
+#include "Constants.h"
+
+/**
+ * @brief  Draws a ChessBoard with SFML.
+ *
+ * Owns the font, the piece textures and the pre-rendered board background
+ * but no game state: the pieces are read from the board on every frame, so
+ * the view never has to be told about moves.
+ */
+class BoardView {
+public:
+	BoardView();
+
+	bool loadTextures();
+	void draw(sf::RenderWindow& window, const ChessBoard& board, const Piece* draggedPiece, sf::Vector2f dragPosition) const;
+
+	static sf::Vector2f squareToPixels(Square square) {
+		return { square.col * SQUARE_SIZE, square.row * SQUARE_SIZE };
+	}
+
+private:
+	void drawPiece(sf::RenderWindow& window, PieceType type, sf::Vector2f position) const;
+
+	sf::RenderTexture boardTexture;
+	sf::Sprite boardSprite;
+	std::map<PieceType, sf::Texture> pieceTextures;
+	sf::Font font;
+};
@@ -1,370 +1,237 @@
 #include "ChessBoard.h"
 
+#include <cstring>
+
 /**
- * @brief  Initializes the chessboard and loads textures.
- *
- * The board background is drawn once into a texture for performance optimization.
- * It also initializes castling rights and sets up the pieces.
+ * @brief  A board in the starting position, copied from a prebuilt template
+ *         so no FEN is parsed and nothing is allocated.
  */
-ChessBoard::ChessBoard() : boardTexture(sf::Vector2u(WINDOW_SIZE, WINDOW_SIZE)), boardSprite(boardTexture.getTexture()), whiteKing(nullptr), blackKing(nullptr), enPassantTarget({ -1,-1 }), castleTarget({ -1,-1 }), whiteKingCastle(true), whiteQueenCastle(true), blackKingCastle(true), blackQueenCastle(true) {
-
-	if (!font.openFromFile("fonts/arial.ttf")) {
-		std::cerr << "Failed to load font!" << std::endl;
-		return;
-	}
-
-	if (!loadTextures()) {
-		std::cerr << "Error loading textures!" << std::endl;
-	}
-
-	sf::Text label(font);
+ChessBoard::ChessBoard() : ChessBoard(startingBoard()) {
+}
 
+/**
+ * @brief  Sets up the pieces from a character layout such as `initialBoard`.
+ */
+ChessBoard::ChessBoard(const char (&layout)[BOARD_SIZE][BOARD_SIZE]) {
+	clearPieces();
 	for (int row = 0; row < BOARD_SIZE; ++row) {
 		for (int col = 0; col < BOARD_SIZE; ++col) {
-			// Draw the chessboard squares
-			sf::RectangleShape square({ SQUARE_SIZE, SQUARE_SIZE });
-			square.setPosition({ col * SQUARE_SIZE, row * SQUARE_SIZE });
-			square.setFillColor((row + col) % 2 == 0 ? sf::Color::White : sf::Color(118, 150, 86));
-			boardTexture.draw(square);
-
-			board[row][col] = generatePiece(row, col);
-			if (board[row][col] && board[row][col]->getType() == PieceType::W_KING) {
-				whiteKing = board[row][col];
-			}
-			else if (board[row][col] && board[row][col]->getType() == PieceType::B_KING) {
-				blackKing = board[row][col];
-			}
-
-			// Determine text color to contrast the square color
-			sf::Color textColor = (row + col) % 2 == 0 ? sf::Color(118, 150, 86) : sf::Color::White;
-
-			// Draw column labels (a-h) at the bottom
-			if (row == BOARD_SIZE - 1) {
-				label.setString(static_cast<char>('a' + col));
-				label.setPosition({ (col + 1) * SQUARE_SIZE - 22 ,  (row + 1) * SQUARE_SIZE - 35 });
-				label.setFillColor(textColor);
-				boardTexture.draw(label);
-			}
-
-			// Draw row labels (1-8) on the left side
-			if (col == 0) {
-				label.setString(std::to_string(8 - row));
-				label.setPosition({ col * SQUARE_SIZE + 5, row * SQUARE_SIZE + 5 });
-				label.setFillColor(textColor);
-				boardTexture.draw(label);
-			}
+			placePiece(Piece::charToPieceType(layout[row][col]), { row, col });
 		}
 	}
-	boardTexture.display();
-	boardSprite.setTexture(boardTexture.getTexture());
+	clearHistory();
+}
+
+const ChessBoard& ChessBoard::startingBoard() {
+	static const ChessBoard board(initialBoard);
+	return board;
 }
 
 /**
- * @brief  Creates a chess piece based on the initial board setup.
- *
- * Uses the predefined `initialBoard` array to generate each piece at its
- * starting position.
+ * @brief  Puts the board back in the starting position for a new game.
  */
-Piece* ChessBoard::generatePiece(int row, int col) {
-	auto type = Piece::charToPieceType(initialBoard[row][col]);
-	if (type == PieceType::NONE) return nullptr;
-
-	Color color = std::isupper(initialBoard[row][col]) ? Color::WHITE : Color::BLACK;
-	Square position = { row, col };
-	const sf::Texture& texture = pieceTextures.at(type);
-	return Piece::createPiece(type, color, pieceTextures.at(type), position, this);
+void ChessBoard::reset() {
+	*this = startingBoard();
+}
+
+void ChessBoard::clearPieces() {
+	pieceCount = 0;
+	std::memset(board, NO_SLOT, sizeof(board));
 }
 
 /**
- * @brief  Loads all piece textures once to improve performance.
+ * @brief  Sets up the position described by a FEN, validated as by Position::setFromFEN.
  *
- * Reduces disk I/O by caching textures in memory, ensuring smooth rendering.
+ * An invalid FEN returns false and leaves the board as it was. The arena is
+ * refilled in place, so loading allocates nothing; validation guarantees no
+ * more than 32 pieces.
  */
-bool ChessBoard::loadTextures() {
-	std::map<PieceType, std::string> textureFiles = {
-		{PieceType::W_PAWN, "pieces-png/wp.png"}, {PieceType::B_PAWN, "pieces-png/bp.png"},
-		{PieceType::W_ROOK, "pieces-png/wr.png"}, {PieceType::B_ROOK, "pieces-png/br.png"},
-		{PieceType::W_KNIGHT, "pieces-png/wn.png"}, {PieceType::B_KNIGHT, "pieces-png/bn.png"},
-		{PieceType::W_BISHOP, "pieces-png/wb.png"}, {PieceType::B_BISHOP, "pieces-png/bb.png"},
-		{PieceType::W_QUEEN, "pieces-png/wq.png"}, {PieceType::B_QUEEN, "pieces-png/bq.png"},
-		{PieceType::W_KING, "pieces-png/wk.png"}, {PieceType::B_KING, "pieces-png/bk.png"}
-	};
-
-	for (const auto& [piece, file] : textureFiles) {
-		if (!pieceTextures[piece].loadFromFile(file)) {
-			std::cerr << "Failed to load texture: " << file << std::endl;
-			return false;
-		}
-		pieceTextures[piece].setSmooth(true); // Anti-aliasing for better visuals
+bool ChessBoard::loadFEN(std::string_view fen) {
+	Position parsed = position;
+	if (!parsed.setFromFEN(fen)) return false;
+
+	position = parsed;
+	accumulator.network = 0;  // Describes the old position; evaluate() rebuilds it
+	clearPieces();
+	Bitboard occupied = position.occupied();
+	while (occupied) {
+		int square = popLsb(occupied);
+		placePiece(Position::toPieceType(position.pieceOn(square)), indexToSquare(square));
 	}
+	clearHistory();
 	return true;
 }
 
 /**
- * @brief  Renders the chessboard and all pieces.
- *
- * The selected piece is not drawn to allow smooth dragging.
+ * @brief  Starts the repetition history at the current position; earlier positions are unknown.
  */
-void ChessBoard::draw(sf::RenderWindow& window, Piece* selectedPiece) const {
-	window.draw(boardSprite);
-	for (int row = 0; row < BOARD_SIZE; ++row) {
-		for (int col = 0; col < BOARD_SIZE; ++col) {
-			Piece* piece = board[row][col];
-			if (piece && piece != selectedPiece) {
-				window.draw(*piece);
-			}
-		}
-	}
+void ChessBoard::clearHistory() {
+	keyHistory[0] = position.getKey();
+	keyCount = 1;
 }
 
 /**
- * @brief  Moves a piece and handles special cases like en passant & castling.
+ * @brief  Takes the next free slot for a piece. Returns false for an empty square or a full arena.
  */
-void ChessBoard::movePiece(Square from, Square to) {
-	Piece* movingPiece = board[from.row][from.col];
-	PieceType type = movingPiece->getType();
-	bool isWhite = movingPiece->isWhite();
+bool ChessBoard::placePiece(PieceType type, Square square) {
+	if (type == PieceType::NONE || pieceCount == MAX_PIECES) return false;
 
-	// Handle En Passant
-	if (type == PieceType::W_PAWN || type == PieceType::B_PAWN) {
-		if (to == enPassantTarget) {
-			delete board[from.row][to.col]; // Capture en passant pawn
-			board[from.row][to.col] = nullptr;
-		}
-	}
-
-	// Handle Castling
-	if (type == PieceType::W_KING || type == PieceType::B_KING) {
-		bool canCastleKingSide = (isWhite && whiteKingCastle) || (!isWhite && blackKingCastle);
-		bool canCastleQueenSide = (isWhite && whiteQueenCastle) || (!isWhite && blackQueenCastle);
-
-		// Kingside Castling (g1/g8)
-		if (to == Square{ from.row, 6 } && canCastleKingSide) {
-			board[from.row][5] = board[from.row][7]; // Move the Rook to f1/f8
-			board[from.row][7] = nullptr;
-			board[from.row][5]->setSquare({ from.row, 5 });
-			board[from.row][5]->setPosition({ 5 * SQUARE_SIZE, from.row * SQUARE_SIZE });
-		}
+	pieces[pieceCount] = Piece(type, square);
+	board[square.row][square.col] = static_cast<uint8_t>(pieceCount++);
+	return true;
+}
 
-		// Queenside Castling (c1/c8)
-		else if (to == Square{ from.row, 2 } && canCastleQueenSide) {
-			board[from.row][3] = board[from.row][0]; // Move the Rook to d1/d8
-			board[from.row][0] = nullptr;
-			board[from.row][3]->setSquare({ from.row, 3 });
-			board[from.row][3]->setPosition({ 3 * SQUARE_SIZE, from.row * SQUARE_SIZE });
-		}
+/**
+ * @brief  Moves a piece given by its squares. Promotions default to a queen unless `promotion` names another piece.
+ */
+void ChessBoard::movePiece(Square from, Square to, char promotion) {
+	int promotionKind = QUEEN;
+	switch (std::tolower(promotion)) {
+	case 'r': promotionKind = ROOK; break;
+	case 'b': promotionKind = BISHOP; break;
+	case 'n': promotionKind = KNIGHT; break;
+	default: break;
 	}
 
-	updateCastleRights(movingPiece);
-
-	delete board[to.row][to.col]; // Capture/Move the piece normally
-	board[to.row][to.col] = movingPiece;
-	board[from.row][from.col] = nullptr;
-
-	movingPiece->setSquare(to);
-	movingPiece->setPosition({ to.col * SQUARE_SIZE, to.row * SQUARE_SIZE });
-
-	updateEnPassant(movingPiece, from, to);
+	makeMove(position.findMove(squareIndex(from), squareIndex(to), promotionKind));
 }
 
-
-
-
 /**
- * @brief  Filters out moves that leave the king in check.
+ * @brief  Plays a legal move and handles special cases like en passant, castling & promotion.
+ *
+ * The move is applied to the bitboard position first; the pieces then follow
+ * whatever the position decided (rook hop, captured pawn, promoted piece).
+ * Returns false, changing nothing, for NO_MOVE.
  */
-std::vector<Square> ChessBoard::getLegalMoves(Piece* piece) {
-	std::vector<Square> legalMoves;
-	std::vector<Square> moves = piece->getPossibleMoves();
-
-	PieceType type = piece->getType();
-	bool isWhite = piece->isWhite();
-	int row = isWhite ? 7 : 0;
+bool ChessBoard::makeMove(Move move) {
+	if (move == NO_MOVE) return false;
+	Square from = indexToSquare(move.from());
+	Square to = indexToSquare(move.to());
 
-	// Handle En Passant 
-	if (type == PieceType::W_PAWN || type == PieceType::B_PAWN) {
-		int dir = piece->isWhite() ? -1 : 1;
-
-		if (enPassantTarget.row == piece->getSquare().row + dir && abs(enPassantTarget.col - piece->getSquare().col) == 1) {
-			moves.push_back(enPassantTarget); // Add en passant move
-		}
+	if (Nnue::isLoaded() && accumulator.network == Nnue::networkId()) {
+		Nnue::update(accumulator, accumulator, position, move);
 	}
 
-	// Handle Castling 
-	else if (piece->getType() == PieceType::W_KING || piece->getType() == PieceType::B_KING) {
-		bool canCastleKingSide = (isWhite && whiteKingCastle) || (!isWhite && blackKingCastle);
-		bool canCastleQueenSide = (isWhite && whiteQueenCastle) || (!isWhite && blackQueenCastle);
-		bool isChecked = isKingInCheck(isWhite);
+	UndoInfo undo;
+	position.makeMove(move, undo);
 
-		if (canCastleKingSide && !isChecked) {
-			if (!board[row][5] && !board[row][6]) { // Squares f1/g1 or f8/g8 must be empty 
-				moves.push_back({ row, 6 });
-			}
-		}
+	// Positions before a capture or pawn move can never come back
+	if (position.getHalfmoveClock() == 0) keyCount = 0;
+	if (keyCount < KEY_HISTORY_SIZE) keyHistory[keyCount++] = position.getKey();
 
-		if (canCastleQueenSide && !isChecked) {
-			if (!board[row][1] && !board[row][2] && !board[row][3]) { // Squares b1/c1/d1 or b8/c8/d8 must be empty
-				moves.push_back({ row, 2 }); // King moves to c1/c8
-			}
-		}
+	uint8_t movingSlot = board[from.row][from.col];
+
+	// Handle En Passant
+	if (move.flag() == MoveFlag::EN_PASSANT) {
+		board[from.row][to.col] = NO_SLOT; // Capture en passant pawn
 	}
 
-	for (const Square& move : moves) {
-		if (!doesMoveLeaveKingInCheck(piece->getSquare(), move)) {
-			legalMoves.push_back(move);
-		}
+	// Handle Castling: move the rook to f1/f8 or d1/d8
+	if (move.flag() == MoveFlag::CASTLING) {
+		int rookFrom = to.col == 6 ? 7 : 0;
+		int rookTo = to.col == 6 ? 5 : 3;
+		board[from.row][rookTo] = board[from.row][rookFrom];
+		board[from.row][rookFrom] = NO_SLOT;
+		pieces[board[from.row][rookTo]].setSquare({ from.row, rookTo });
 	}
-	return legalMoves;
-}
 
-/**
- * @brief  Checks if checkmate happened.
- */
-bool ChessBoard::isCheckMate(bool isWhite) {
-	if (!isKingInCheck(isWhite)) return false;
+	board[to.row][to.col] = movingSlot; // Capture/Move the piece normally
+	board[from.row][from.col] = NO_SLOT;
 
-	for (int row = 0; row < BOARD_SIZE; ++row) {
-		for (int col = 0; col < BOARD_SIZE; ++col) {
-			Piece* piece = getPiece({ row, col });
-			if (!piece || piece->isWhite() != isWhite) continue;
+	pieces[movingSlot].setSquare(to);
 
-			std::vector<Square> moves = getLegalMoves(piece);
-			if (!moves.empty()) return false;
-		}
+	// Handle Promotion: the pawn's slot becomes the promoted piece
+	if (move.flag() == MoveFlag::PROMOTION) {
+		pieces[movingSlot].setType(Position::toPieceType(position.pieceOn(move.to())));
 	}
 	return true;
 }
 
 /**
- * @brief  Simulates a move to determine if it exposes the king to check.
- *
- * The board state is temporarily modified, then restored to ensure no real
- * changes are made.
+ * @brief  Returns every legal move of a piece.
  *
- * TODO: Find out how to make this const. The board doest really change...
+ * Delegates to the bitboard move generator. Pieces of the side not to move
+ * have no legal moves, and of the four promotion choices only the queen is
+ * kept, so each destination square appears once.
  */
-bool ChessBoard::doesMoveLeaveKingInCheck(Square from, Square to) {
-	Piece* movedPiece = getPiece(from);
-	Piece* capturedPiece = getPiece(to);
-
-	// Simulate move
-	board[to.row][to.col] = movedPiece;
-	board[from.row][from.col] = nullptr;
-	movedPiece->setSquare(to);
-
-	bool isInCheck = isKingInCheck(movedPiece->isWhite());
-
-	// Undo move
-	board[from.row][from.col] = movedPiece;
-	board[to.row][to.col] = capturedPiece;
-	movedPiece->setSquare(from);
-
-	return isInCheck;
+MoveList ChessBoard::getLegalMoves(const Piece* piece) {
+	MoveList legalMoves;
+	if (piece->isWhite() != (position.sideToMove() == Color::WHITE)) return legalMoves;
+
+	MoveList moves;
+	position.generateLegalMoves(moves);
+	int from = squareIndex(piece->getSquare());
+
+	for (Move move : moves) {
+		if (move.from() != from) continue;
+		if (move.flag() == MoveFlag::PROMOTION && move.promotion() != QUEEN) continue;
+		legalMoves.push_back(move);
+	}
+	return legalMoves;
 }
 
 /**
- * @brief  Checks if the given player's king is under attack.
- *
- * Iterates over all opponent pieces and determines if any of them can legally
- * move to the kings square.
+ * @brief  Checks if checkmate happened.
  */
-bool ChessBoard::isKingInCheck(bool isWhite) const {
-	Square kingSquare = isWhite ? whiteKing->getSquare() : blackKing->getSquare();
-
-	for (int row = 0; row < BOARD_SIZE; ++row) {
-		for (int col = 0; col < BOARD_SIZE; ++col) {
-			Piece* piece = getPiece({ row, col });
-			if (!piece || piece->isWhite() == isWhite) continue;
-
-			std::vector<Square> moves = piece->getPossibleMoves();
-			if (std::find(moves.begin(), moves.end(), kingSquare) != moves.end()) {
-				return true;
-			}
-		}
-	}
-	return false;
+bool ChessBoard::isCheckMate(bool isWhite) {
+	return isWhite == (position.sideToMove() == Color::WHITE) && position.inCheck() && !position.hasLegalMove();
 }
 
+/**
+ * @brief  Whether the game is over: mate, stalemate or a draw by repetition, the fifty-move rule or material.
+ */
+GameStatus ChessBoard::gameStatus() const {
+	return position.gameStatus(keyHistory, keyCount - 1);
+}
 
 /**
- * @brief  Updates castling rights when a king or rook moves.
+ * @brief  Static evaluation in centipawns from white's point of view, for an evaluation bar.
  *
- * If a king moves, both castling rights are revoked.
- * If a rook moves, only the corresponding castling right is revoked.
+ * Uses the NNUE network when one is loaded and the piece-square evaluation otherwise.
  */
-void ChessBoard::updateCastleRights(Piece* piece) {
-	int row = piece->getSquare().row;
-	int col = piece->getSquare().col;
-
-	switch (piece->getType()) {
-	case PieceType::W_KING:
-		whiteKingCastle = whiteQueenCastle = false;
-		break;
-	case PieceType::B_KING:
-		blackKingCastle = blackQueenCastle = false;
-		break;
-	case PieceType::W_ROOK:
-		if (row == 7) (col == 0) ? whiteQueenCastle = false : whiteKingCastle = false;
-		break;
-	case PieceType::B_ROOK:
-		if (row == 0) (col == 0) ? blackQueenCastle = false : blackKingCastle = false;
-		break;
-	default:
-		break;
+int ChessBoard::evaluate() const {
+	int score;
+	if (Nnue::isLoaded()) {
+		if (accumulator.network != Nnue::networkId()) Nnue::refresh(accumulator, position);
+		score = Nnue::evaluate(accumulator, static_cast<int>(position.sideToMove()));
 	}
+	else {
+		score = position.evaluate();
+	}
+	return position.sideToMove() == Color::WHITE ? score : -score;
 }
 
-
 /**
- * @brief  Determines the en passant target square if applicable.
+ * @brief  Checks if the given player's king is under attack.
  */
-void ChessBoard::updateEnPassant(Piece* movedPiece, Square from, Square to) {
-	enPassantTarget = { -1, -1 }; // Reset by default
-
-	int startRow = movedPiece->isWhite() ? 6 : 1;
-	int targetRow = movedPiece->isWhite() ? 4 : 3;
-	int enPassantRow = movedPiece->isWhite() ? 5 : 2;
-
-	// Only applies to a double move from the starting position
-	if (from.row == startRow && to.row == targetRow) {
-		enPassantTarget = { enPassantRow, to.col };
-	}
+bool ChessBoard::isKingInCheck(bool isWhite) const {
+	int color = isWhite ? WHITE : BLACK;
+	return position.isSquareAttacked(position.kingSquare(color), color ^ 1);
 }
 
 std::string ChessBoard::getCastlingRights() const {
 	std::string rights;
-	if (whiteKingCastle) rights += "K";
-	if (whiteQueenCastle) rights += "Q";
-	if (blackKingCastle) rights += "k";
-	if (blackQueenCastle) rights += "q";
+	uint8_t castling = position.getCastlingRights();
+	if (castling & WHITE_OO) rights += "K";
+	if (castling & WHITE_OOO) rights += "Q";
+	if (castling & BLACK_OO) rights += "k";
+	if (castling & BLACK_OOO) rights += "q";
 	return rights.empty() ? "-" : rights;
 }
 
-std::string ChessBoard::generateFEN(bool isWhiteTurn, int halfMoveClock, int fullMoveCount) const {
-	return boardToFEN() + " " + (isWhiteTurn ? "w" : "b") + " " + getCastlingRights() + " " + (enPassantTarget == Square{-1,-1} ? "-" : squareToLiteral(enPassantTarget)) + " " + std::to_string(halfMoveClock) + " " + std::to_string(fullMoveCount);
+/**
+ * @brief  The FEN of the current position, including the clocks the position keeps.
+ */
+std::string ChessBoard::generateFEN() const {
+	char buffer[FEN_BUFFER_SIZE];
+	return std::string(buffer, position.writeFEN(buffer));
 }
 
+/**
+ * @brief  Just the piece placement field of the FEN.
+ */
 std::string ChessBoard::boardToFEN() const {
-	std::string fen;
-	for (int row = 0; row < BOARD_SIZE; ++row) {
-		int emptyCount = 0;
-		for (int col = 0; col < BOARD_SIZE; ++col) {
-			char piece = Piece::pieceTypeToChar(board[row][col] ? board[row][col]->getType() : PieceType::NONE);
-			if (piece == '.') {
-				emptyCount++;
-			}
-			else {
-				if (emptyCount > 0) {
-					fen += std::to_string(emptyCount);
-					emptyCount = 0;
-				}
-				fen += piece;
-			}
-		}
-		if (emptyCount > 0) fen += std::to_string(emptyCount);
-		if (row < BOARD_SIZE - 1) fen += "/";
-	}
+	std::string fen = generateFEN();
+	fen.resize(fen.find(' '));
 	return fen;
 }
-
-
@@ -1,48 +1,83 @@
 #pragma once
 
-#include <SFML/Graphics.hpp>
-#include <map>
-#include <iostream>
-#include <vector>
+#include <algorithm>
 #include <string>
+#include <string_view>
+#include <vector>
 
 #include "Constants.h"
+#include "Nnue.h"
 #include "Piece.h"
-#include "Pawn.h"
-#include "Knight.h"
-#include "Bishop.h"
-#include "Rook.h"
-#include "Queen.h"
-#include "King.h"
-
+#include "Position.h"
+
+/**
+ * @brief  The game's rules model: a Position plus a Piece per occupied square.
+ *
+ * Needs no window, font or texture, so it can be created in tools and
+ * services as cheaply as the Position it wraps. BoardView renders it.
+ *
+ * Pieces live in a fixed arena of 32 slots inside the board and squares
+ * refer to them by slot, so a board never touches the heap and copies
+ * with a plain memberwise copy. A capture just empties the square and a
+ * promotion reuses the pawn's slot; slots are only handed out when a
+ * position is set up.
+ *
+ * The board also remembers the keys of the positions since the last capture
+ * or pawn move, which is all gameStatus() needs to spot a threefold
+ * repetition.
+ *
+ * While an NNUE network is loaded its accumulator is kept up to date move
+ * by move as well, so evaluate() costs one output layer.
+ */
 class ChessBoard {
 public:
-    ChessBoard();
+    static constexpr int MAX_PIECES = 32;
 
-    bool loadTextures();
-    void draw(sf::RenderWindow& window, Piece* selectedPiece) const;
+    ChessBoard();
+    void reset();
+    bool loadFEN(std::string_view fen);
 
-    Piece* generatePiece(int row, int col);
-    void movePiece(Square fromSquare, Square toSquare);
-    std::vector<Square> getLegalMoves(Piece* piece);
+    void movePiece(Square fromSquare, Square toSquare, char promotion = 'q');
+    bool makeMove(Move move);
+    MoveList getLegalMoves(const Piece* piece);
 
-    void updateCastleRights(Piece* piece);
-    void updateEnPassant(Piece* movedPiece, Square from, Square to);
     std::string getCastlingRights() const;
 
     bool isCheckMate(bool isWhite);
-    bool doesMoveLeaveKingInCheck(Square from, Square to);
+    GameStatus gameStatus() const;
+    int evaluate() const;
     bool isKingInCheck(bool isWhite) const;
 
-    std::string generateFEN(bool isWhiteTurn, int halfMoveClock, int fullMoveCount) const;
-    std::string boardToFEN() const;
+    const Position& getPosition() const {
+        return position;
+    }
 
-    const sf::Texture& getPieceTexture(Piece* piece) const {
-        return pieceTextures.at(piece->getType());
+    uint64_t getHash() const {
+        return position.getKey();
+    }
+    // Keys of the earlier positions since the last irreversible move, oldest first
+    std::vector<uint64_t> previousKeys() const {
+        return std::vector<uint64_t>(keyHistory, keyHistory + std::max(keyCount - 1, 0));
     }
 
-    Piece* getPiece(Square square) const {
-        return board[square.row][square.col];
+    // Static exchange evaluation of a capture, in centipawns for the side making it
+    int see(Move move) const {
+        return position.see(move);
+    }
+    // Pieces of the side to move that the opponent could win material by capturing
+    Bitboard hangingPieces() const {
+        return position.hangingPieces(static_cast<int>(position.sideToMove()));
+    }
+
+    size_t writeFEN(char* buffer) const {
+        return position.writeFEN(buffer);
+    }
+    std::string generateFEN() const;
+    std::string boardToFEN() const;
+
+    const Piece* getPiece(Square square) const {
+        uint8_t slot = board[square.row][square.col];
+        return slot == NO_SLOT ? nullptr : &pieces[slot];
     }
 
     bool isSquareValid(Square square) const {
@@ -50,7 +85,7 @@ public:
     }
 
     bool isSquareOccupied(const Square& square) const {
-        return board[square.row][square.col] != nullptr;
+        return board[square.row][square.col] != NO_SLOT;
     }
 
     static Square literalToSquare(std::string s) {
@@ -62,6 +97,17 @@ public:
     }
 
 private:
+    static constexpr uint8_t NO_SLOT = 0xFF;
+
+    // The fifty-move rule ends the game before more reversible plies than this pile up
+    static constexpr int KEY_HISTORY_SIZE = 128;
+
+    explicit ChessBoard(const char (&layout)[BOARD_SIZE][BOARD_SIZE]);
+    static const ChessBoard& startingBoard();
+    void clearPieces();
+    void clearHistory();
+    bool placePiece(PieceType type, Square square);
+
     static constexpr char initialBoard[BOARD_SIZE][BOARD_SIZE] = {
         {'r', 'n', 'b', 'q', 'k', 'b', 'n', 'r'},
         {'p', 'p', 'p', 'p', 'p', 'p', 'p', 'p'},
@@ -73,14 +119,15 @@ private:
         {'R', 'N', 'B', 'Q', 'K', 'B', 'N', 'R'}
     };
 
-    Piece* board[BOARD_SIZE][BOARD_SIZE]{};
-    sf::RenderTexture boardTexture;
-    sf::Sprite boardSprite;
-    std::map<PieceType, sf::Texture> pieceTextures;
-    sf::Font font;
+    Piece pieces[MAX_PIECES];
+    int pieceCount = 0;
+    uint8_t board[BOARD_SIZE][BOARD_SIZE];  // Slot in `pieces`, or NO_SLOT
+
+    uint64_t keyHistory[KEY_HISTORY_SIZE];  // Since the last irreversible move, current position last
+    int keyCount = 0;
+
+    mutable Nnue::Accumulator accumulator;  // Rebuilt lazily when stale for the loaded network
 
-    Piece *whiteKing, *blackKing;
-    Square enPassantTarget;
-    Square castleTarget;
-    bool whiteKingCastle, whiteQueenCastle, blackKingCastle, blackQueenCastle;
+    // Rules state; the pieces above only mirror it for the view
+    Position position;
 };
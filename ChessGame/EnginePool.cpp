@@ -0,0 +1,122 @@
+#include "EnginePool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+#include <thread>
+
+#include "EngineRequest.h"
+
+namespace {
+	// A job with a movetime is stopped after this many times its movetime plus the slack
+	constexpr int64_t MOVETIME_TIMEOUT_FACTOR = 4;
+	constexpr int64_t MOVETIME_TIMEOUT_SLACK_MS = 1000;
+
+	// Deadline of jobs without a movetime until setJobTimeout() changes it
+	constexpr int64_t DEFAULT_JOB_TIMEOUT_MS = 10 * 60 * 1000;
+}
+
+/**
+ * @brief  Starts one engine per entry, in parallel, and applies its Threads and Hash options.
+ *
+ * Engines that fail to start stay in the pool but take no jobs.
+ */
+EnginePool::EnginePool(const std::vector<EngineOptions>& engineOptions) : engines(engineOptions.size()), jobTimeoutMs(DEFAULT_JOB_TIMEOUT_MS), nextJob(0) {
+	std::vector<std::thread> starters;
+	for (size_t i = 0; i < engineOptions.size(); ++i) {
+		starters.emplace_back([this, i, &engineOptions]() {
+			const EngineOptions& options = engineOptions[i];
+			engines[i] = std::make_unique<Stockfish>(options.path);
+			if (!engines[i]->isRunning()) return;
+			engines[i]->setOption("Threads", std::to_string(options.threads));
+			engines[i]->setOption("Hash", std::to_string(options.hashMB));
+			engines[i]->newGame();
+		});
+	}
+	for (std::thread& starter : starters) starter.join();
+}
+
+EnginePool::EnginePool(const EngineOptions& options, int count)
+	: EnginePool(std::vector<EngineOptions>(count > 0 ? count : 1, options)) {
+}
+
+int EnginePool::runningCount() const {
+	int count = 0;
+	for (const auto& engine : engines) count += engine->isRunning();
+	return count;
+}
+
+/**
+ * @brief  Analyses every job and returns the results in input order.
+ *
+ * Jobs run in rounds: the first round takes every job, and each later one
+ * retries the jobs whose engine died, on the engines still running. Jobs
+ * that failed more than MAX_RETRIES times, or that no engine was left to
+ * run, come back with `engine == -1` and an incomplete analysis.
+ */
+std::vector<AnalysisResult> EnginePool::analyzeBatch(const std::vector<AnalysisJob>& jobs) {
+	std::vector<AnalysisResult> results(jobs.size());
+	queue.resize(jobs.size());
+	std::iota(queue.begin(), queue.end(), size_t(0));
+	failures.assign(jobs.size(), 0);
+
+	// Every job is retried at most MAX_RETRIES times, so this ends after MAX_RETRIES + 1 rounds
+	while (!queue.empty() && runningCount() > 0) {
+		nextJob = 0;
+		failedJobs.clear();
+
+		std::vector<std::thread> drivers;
+		for (int i = 0; i < size(); ++i) {
+			if (engines[i]->isRunning()) drivers.emplace_back(&EnginePool::analyzeWith, this, i, std::cref(jobs), std::ref(results));
+		}
+		for (std::thread& driver : drivers) driver.join();
+
+		std::sort(failedJobs.begin(), failedJobs.end());
+		queue = failedJobs;
+	}
+	queue.clear();
+	return results;
+}
+
+/**
+ * @brief  Driver loop for one engine: takes jobs off the queue until it is empty or the engine dies.
+ *
+ * Each job runs as an EngineRequest with the job's deadline, so an engine
+ * that hangs is stopped, and killed if it does not answer. The job the
+ * engine dies on is marked failed and, unless it has failed too often,
+ * left for the next round.
+ */
+void EnginePool::analyzeWith(int engineIndex, const std::vector<AnalysisJob>& jobs, std::vector<AnalysisResult>& results) {
+	Stockfish& engine = *engines[engineIndex];
+
+	while (engine.isRunning()) {
+		size_t position = nextJob.fetch_add(1, std::memory_order_relaxed);
+		if (position >= queue.size()) break;
+
+		size_t index = queue[position];
+		const AnalysisJob& job = jobs[index];
+		AnalysisResult& result = results[index];
+		auto start = std::chrono::steady_clock::now();
+		std::unique_ptr<EngineRequest> request = EngineRequest::search(engine, job.fen, job.multiPV, job.limits, jobTimeout(job));
+		result.analysis = request->get();
+		request.reset();
+		result.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+		if (result.analysis.completed) {
+			result.engine = engineIndex;
+			continue;
+		}
+
+		result.engine = -1;
+		std::lock_guard<std::mutex> lock(failedMutex);
+		if (++failures[index] <= MAX_RETRIES) failedJobs.push_back(index);
+	}
+}
+
+/**
+ * @brief  Deadline for one job: a multiple of its movetime if it has one, else the pool's job timeout.
+ */
+int64_t EnginePool::jobTimeout(const AnalysisJob& job) const {
+	if (job.limits.moveTimeMs <= 0) return jobTimeoutMs;
+	int64_t timeout = job.limits.moveTimeMs * MOVETIME_TIMEOUT_FACTOR + MOVETIME_TIMEOUT_SLACK_MS;
+	return jobTimeoutMs > 0 ? std::min(timeout, jobTimeoutMs) : timeout;
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Stockfish.h"
+
+/**
+ * @brief  How to start one engine process of the pool.
+ */
+struct EngineOptions {
+	std::string path;
+	int threads = 1;
+	int hashMB = 16;
+};
+
+struct AnalysisJob {
+	std::string fen;
+	int multiPV = 1;
+	UciLimits limits;
+};
+
+struct AnalysisResult {
+	UciAnalysis analysis;
+	int64_t timeMs = 0;   // Wall time of this job alone
+	int engine = -1;      // Index of the engine that ran the job, -1 if none did
+};
+
+/**
+ * @brief  A fixed set of UCI engine processes that analyse positions in parallel.
+ *
+ * Each engine is driven by its own thread during analyzeBatch, pulling the
+ * next job from a shared queue as soon as it is free, so a batch keeps every
+ * engine busy until the queue is empty. A job whose engine dies before
+ * answering is run again, at most MAX_RETRIES times, on an engine that is
+ * still alive, so a position that crashes the engine cannot take the whole
+ * pool down with it. A job that overruns its deadline is stopped, and its
+ * engine is killed if it does not answer. Engines persist between batches
+ * and keep their hash, which helps when consecutive positions come from the
+ * same game.
+ */
+class EnginePool {
+public:
+	static constexpr int MAX_RETRIES = 1;
+
+	explicit EnginePool(const std::vector<EngineOptions>& engineOptions);
+	EnginePool(const EngineOptions& options, int count);
+
+	std::vector<AnalysisResult> analyzeBatch(const std::vector<AnalysisJob>& jobs);
+
+	int size() const {
+		return static_cast<int>(engines.size());
+	}
+	int runningCount() const;
+
+	// Longest a job without a movetime may run; zero for no limit
+	void setJobTimeout(int64_t milliseconds) {
+		jobTimeoutMs = milliseconds;
+	}
+
+private:
+	void analyzeWith(int engineIndex, const std::vector<AnalysisJob>& jobs, std::vector<AnalysisResult>& results);
+	int64_t jobTimeout(const AnalysisJob& job) const;
+
+	std::vector<std::unique_ptr<Stockfish>> engines;
+	int64_t jobTimeoutMs;
+
+	// Job indices of the current round, handed out in order
+	std::vector<size_t> queue;
+	std::atomic<size_t> nextJob;
+
+	// Jobs whose engine died during the current round, and how often each job has failed
+	std::mutex failedMutex;
+	std::vector<size_t> failedJobs;
+	std::vector<int> failures;
+};
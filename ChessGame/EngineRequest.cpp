@@ -0,0 +1,110 @@
+#include "EngineRequest.h"
+
+namespace {
+	// How long an engine gets to answer "stop" with a bestmove before it is considered hung
+	constexpr auto STOP_GRACE_PERIOD = std::chrono::seconds(2);
+}
+
+EngineRequest::EngineRequest(Stockfish& engine, int64_t timeoutMs, bool ponder, const std::string& ponderMove)
+	: engine(engine), timeoutMs(timeoutMs), ponderMove(ponderMove), pondering(ponder) {
+	if (!ponder && timeoutMs > 0) deadline = (Clock::now() + std::chrono::milliseconds(timeoutMs)).time_since_epoch().count();
+}
+
+/**
+ * @brief  Starts searching `fen` in the background, once `previous` (if any) has been stopped.
+ */
+std::unique_ptr<EngineRequest> EngineRequest::search(Stockfish& engine, const std::string& fen, int multiPV, const UciLimits& limits, int64_t timeoutMs,
+	std::unique_ptr<EngineRequest> previous) {
+	std::unique_ptr<EngineRequest> request(new EngineRequest(engine, timeoutMs, false, ""));
+	request->start("position fen " + fen, multiPV, limits.goCommand(), std::move(previous));
+	return request;
+}
+
+/**
+ * @brief  Starts pondering on `fen` after `ponderMove`, the opponent's expected reply.
+ *
+ * `limits` only take effect after ponderhit(), as in UCI "go ponder".
+ */
+std::unique_ptr<EngineRequest> EngineRequest::ponder(Stockfish& engine, const std::string& fen, const std::string& ponderMove, int multiPV, const UciLimits& limits, int64_t timeoutMs,
+	std::unique_ptr<EngineRequest> previous) {
+	std::unique_ptr<EngineRequest> request(new EngineRequest(engine, timeoutMs, true, ponderMove));
+	std::string goCommand = limits.goCommand();
+	request->start("position fen " + fen + " moves " + ponderMove, multiPV, "go ponder" + goCommand.substr(2), std::move(previous));
+	return request;
+}
+
+EngineRequest::~EngineRequest() {
+	stop();
+	if (worker.joinable()) worker.join();
+}
+
+void EngineRequest::start(const std::string& positionCommand, int multiPV, const std::string& goCommand, std::unique_ptr<EngineRequest> previousRequest) {
+	previous = std::move(previousRequest);
+	if (previous) previous->stop();
+	worker = std::thread([this, positionCommand, multiPV, goCommand]() {
+		previous.reset();  // Joins it: its bestmove must be read before this search starts
+		UciAnalysis analysis = engine.runSearch(positionCommand, multiPV, goCommand, [this]() { return checkAbort(); });
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			result = std::move(analysis);
+			done = true;
+		}
+		finished.notify_all();
+	});
+}
+
+/**
+ * @brief  Waits up to `timeout` for the search to finish. Returns true if it has.
+ */
+bool EngineRequest::waitFor(std::chrono::milliseconds timeout) {
+	std::unique_lock<std::mutex> lock(mutex);
+	return finished.wait_for(lock, timeout, [this]() { return done.load(); });
+}
+
+/**
+ * @brief  Waits for the search to finish and returns its result.
+ */
+const UciAnalysis& EngineRequest::get() {
+	std::unique_lock<std::mutex> lock(mutex);
+	finished.wait(lock, [this]() { return done.load(); });
+	return result;
+}
+
+/**
+ * @brief  Asks the engine to stop; the result arrives with the best move found so far.
+ */
+void EngineRequest::stop() {
+	stopRequested = true;
+}
+
+/**
+ * @brief  The opponent played the expected move: keep searching, now for real.
+ */
+void EngineRequest::ponderhit() {
+	if (!pondering || done) return;
+	if (timeoutMs > 0) deadline = (Clock::now() + std::chrono::milliseconds(timeoutMs)).time_since_epoch().count();
+	pondering = false;
+	engine.sendCommand("ponderhit");
+}
+
+/**
+ * @brief  Polled by the worker while it waits for engine output.
+ *
+ * Sends "stop" once when asked to or when the deadline passes, and aborts
+ * the read if no bestmove follows within the grace period.
+ */
+bool EngineRequest::checkAbort() {
+	Clock::time_point now = Clock::now();
+	if (!stopSent) {
+		int64_t due = deadline;
+		bool expired = due != 0 && now.time_since_epoch().count() >= due;
+		if (!stopRequested && !expired) return false;
+
+		timedOut = expired && !stopRequested;
+		stopSent = true;
+		giveUpAt = now + STOP_GRACE_PERIOD;
+		engine.sendCommand("stop");
+		return false;
+	}
+	return now >= giveUpAt;
+}
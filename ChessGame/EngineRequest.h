@@ -0,0 +1,89 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "Stockfish.h"
+
+/**
+ * @brief  One search running on a Stockfish engine in the background.
+ *
+ * The search runs on its own thread; the caller polls isDone() or waits,
+ * and can stop() it at any time to get the best move found so far. A
+ * timeout stops the engine the same way, and an engine that does not answer
+ * "stop" within a grace period is given up on.
+ *
+ * A ponder request searches the position after the move the engine expects
+ * the opponent to play. If the opponent plays it, ponderhit() turns the
+ * ponder search into the real one (and starts its timeout) without losing
+ * the work done so far; otherwise stop() it and start a fresh search.
+ *
+ * Only one request may run on an engine at a time. A new request can be
+ * handed the one it replaces as `previous`: that request is stopped, and
+ * the new worker waits for it before using the engine, so the caller never
+ * blocks on an engine that is slow to answer "stop". Destroying a request
+ * stops and joins it.
+ */
+class EngineRequest {
+public:
+	static std::unique_ptr<EngineRequest> search(Stockfish& engine, const std::string& fen, int multiPV, const UciLimits& limits, int64_t timeoutMs = 0,
+		std::unique_ptr<EngineRequest> previous = nullptr);
+	static std::unique_ptr<EngineRequest> ponder(Stockfish& engine, const std::string& fen, const std::string& ponderMove, int multiPV, const UciLimits& limits, int64_t timeoutMs = 0,
+		std::unique_ptr<EngineRequest> previous = nullptr);
+	~EngineRequest();
+
+	EngineRequest(const EngineRequest&) = delete;
+	EngineRequest& operator=(const EngineRequest&) = delete;
+
+	bool isDone() const {
+		return done;
+	}
+	bool waitFor(std::chrono::milliseconds timeout);
+	const UciAnalysis& get();
+
+	void stop();
+	void ponderhit();
+
+	bool isPondering() const {
+		return pondering;
+	}
+	bool hasTimedOut() const {
+		return timedOut;
+	}
+	const std::string& getPonderMove() const {
+		return ponderMove;
+	}
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	EngineRequest(Stockfish& engine, int64_t timeoutMs, bool ponder, const std::string& ponderMove);
+	void start(const std::string& positionCommand, int multiPV, const std::string& goCommand, std::unique_ptr<EngineRequest> previous);
+	bool checkAbort();
+
+	Stockfish& engine;
+	int64_t timeoutMs;      // Zero means no timeout
+	std::string ponderMove;
+	std::unique_ptr<EngineRequest> previous;  // Stopped request the worker waits for before starting
+	std::thread worker;
+
+	std::mutex mutex;
+	std::condition_variable finished;
+	std::atomic<bool> done{ false };
+	UciAnalysis result;
+
+	std::atomic<bool> pondering;
+	std::atomic<bool> stopRequested{ false };
+	std::atomic<bool> timedOut{ false };
+	std::atomic<int64_t> deadline{ 0 };  // Clock ticks; zero while there is none (pondering or no timeout)
+
+	// Only touched by the worker thread
+	bool stopSent = false;
+	Clock::time_point giveUpAt;
+};
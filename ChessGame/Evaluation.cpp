@@ -0,0 +1,113 @@
+#include "Evaluation.h"
+
+namespace {
+	constexpr int MIDGAME_VALUES[PIECE_KIND_NB] = { 100, 320, 330, 500, 900, 0 };
+	constexpr int ENDGAME_VALUES[PIECE_KIND_NB] = { 120, 300, 320, 530, 950, 0 };
+
+	/*
+	 * Piece-square bonuses for white, laid out like the board: the first row
+	 * is rank 8 and index 0 is a8. Black uses the same tables mirrored.
+	 */
+	constexpr int8_t PAWN_MIDGAME[SQUARE_NB] = {
+		  0,  0,  0,  0,  0,  0,  0,  0,
+		 50, 50, 50, 50, 50, 50, 50, 50,
+		 10, 10, 20, 30, 30, 20, 10, 10,
+		  5,  5, 10, 25, 25, 10,  5,  5,
+		  0,  0,  0, 20, 20,  0,  0,  0,
+		  5, -5,-10,  0,  0,-10, -5,  5,
+		  5, 10, 10,-20,-20, 10, 10,  5,
+		  0,  0,  0,  0,  0,  0,  0,  0
+	};
+	constexpr int8_t PAWN_ENDGAME[SQUARE_NB] = {
+		  0,  0,  0,  0,  0,  0,  0,  0,
+		 80, 80, 80, 80, 80, 80, 80, 80,
+		 50, 50, 50, 50, 50, 50, 50, 50,
+		 30, 30, 30, 30, 30, 30, 30, 30,
+		 15, 15, 15, 15, 15, 15, 15, 15,
+		  5,  5,  5,  5,  5,  5,  5,  5,
+		  0,  0,  0,  0,  0,  0,  0,  0,
+		  0,  0,  0,  0,  0,  0,  0,  0
+	};
+	constexpr int8_t KNIGHT_TABLE[SQUARE_NB] = {
+		-50,-40,-30,-30,-30,-30,-40,-50,
+		-40,-20,  0,  0,  0,  0,-20,-40,
+		-30,  0, 10, 15, 15, 10,  0,-30,
+		-30,  5, 15, 20, 20, 15,  5,-30,
+		-30,  0, 15, 20, 20, 15,  0,-30,
+		-30,  5, 10, 15, 15, 10,  5,-30,
+		-40,-20,  0,  5,  5,  0,-20,-40,
+		-50,-40,-30,-30,-30,-30,-40,-50
+	};
+	constexpr int8_t BISHOP_TABLE[SQUARE_NB] = {
+		-20,-10,-10,-10,-10,-10,-10,-20,
+		-10,  0,  0,  0,  0,  0,  0,-10,
+		-10,  0,  5, 10, 10,  5,  0,-10,
+		-10,  5,  5, 10, 10,  5,  5,-10,
+		-10,  0, 10, 10, 10, 10,  0,-10,
+		-10, 10, 10, 10, 10, 10, 10,-10,
+		-10,  5,  0,  0,  0,  0,  5,-10,
+		-20,-10,-10,-10,-10,-10,-10,-20
+	};
+	constexpr int8_t ROOK_TABLE[SQUARE_NB] = {
+		  0,  0,  0,  0,  0,  0,  0,  0,
+		  5, 10, 10, 10, 10, 10, 10,  5,
+		 -5,  0,  0,  0,  0,  0,  0, -5,
+		 -5,  0,  0,  0,  0,  0,  0, -5,
+		 -5,  0,  0,  0,  0,  0,  0, -5,
+		 -5,  0,  0,  0,  0,  0,  0, -5,
+		 -5,  0,  0,  0,  0,  0,  0, -5,
+		  0,  0,  0,  5,  5,  0,  0,  0
+	};
+	constexpr int8_t QUEEN_TABLE[SQUARE_NB] = {
+		-20,-10,-10, -5, -5,-10,-10,-20,
+		-10,  0,  0,  0,  0,  0,  0,-10,
+		-10,  0,  5,  5,  5,  5,  0,-10,
+		 -5,  0,  5,  5,  5,  5,  0, -5,
+		  0,  0,  5,  5,  5,  5,  0, -5,
+		-10,  5,  5,  5,  5,  5,  0,-10,
+		-10,  0,  5,  0,  0,  0,  0,-10,
+		-20,-10,-10, -5, -5,-10,-10,-20
+	};
+	// The king hides behind its pawns while queens are on and heads for the centre after
+	constexpr int8_t KING_MIDGAME[SQUARE_NB] = {
+		-30,-40,-40,-50,-50,-40,-40,-30,
+		-30,-40,-40,-50,-50,-40,-40,-30,
+		-30,-40,-40,-50,-50,-40,-40,-30,
+		-30,-40,-40,-50,-50,-40,-40,-30,
+		-20,-30,-30,-40,-40,-30,-30,-20,
+		-10,-20,-20,-20,-20,-20,-20,-10,
+		 20, 20,  0,  0,  0,  0, 20, 20,
+		 20, 30, 10,  0,  0, 10, 30, 20
+	};
+	constexpr int8_t KING_ENDGAME[SQUARE_NB] = {
+		-50,-40,-30,-20,-20,-30,-40,-50,
+		-30,-20,-10,  0,  0,-10,-20,-30,
+		-30,-10, 20, 30, 30, 20,-10,-30,
+		-30,-10, 30, 40, 40, 30,-10,-30,
+		-30,-10, 30, 40, 40, 30,-10,-30,
+		-30,-10, 20, 30, 30, 20,-10,-30,
+		-30,-30,  0,  0,  0,  0,-30,-30,
+		-50,-30,-30,-30,-30,-30,-30,-50
+	};
+
+	constexpr const int8_t* MIDGAME_TABLES[PIECE_KIND_NB] = { PAWN_MIDGAME, KNIGHT_TABLE, BISHOP_TABLE, ROOK_TABLE, QUEEN_TABLE, KING_MIDGAME };
+	constexpr const int8_t* ENDGAME_TABLES[PIECE_KIND_NB] = { PAWN_ENDGAME, KNIGHT_TABLE, BISHOP_TABLE, ROOK_TABLE, QUEEN_TABLE, KING_ENDGAME };
+}
+
+int16_t Eval::midgame[PIECE_NB][SQUARE_NB];
+int16_t Eval::endgame[PIECE_NB][SQUARE_NB];
+
+/**
+ * @brief  Folds material into the piece-square tables for both colours.
+ */
+void Eval::init() {
+	for (int kind = PAWN; kind < PIECE_KIND_NB; ++kind) {
+		for (int square = 0; square < SQUARE_NB; ++square) {
+			int mirrored = square ^ 56;  // Same file, opposite rank
+			midgame[makePiece(WHITE, kind)][square] = static_cast<int16_t>(MIDGAME_VALUES[kind] + MIDGAME_TABLES[kind][square]);
+			endgame[makePiece(WHITE, kind)][square] = static_cast<int16_t>(ENDGAME_VALUES[kind] + ENDGAME_TABLES[kind][square]);
+			midgame[makePiece(BLACK, kind)][square] = static_cast<int16_t>(-(MIDGAME_VALUES[kind] + MIDGAME_TABLES[kind][mirrored]));
+			endgame[makePiece(BLACK, kind)][square] = static_cast<int16_t>(-(ENDGAME_VALUES[kind] + ENDGAME_TABLES[kind][mirrored]));
+		}
+	}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Bitboard.h"
+#include "Position.h"
+
+/**
+ * @brief  Tapered piece-square evaluation tables.
+ *
+ * Every piece on every square has a midgame and an endgame value that
+ * includes its material, positive for white and negative for black. The
+ * Position adds and subtracts these as pieces move, together with a game
+ * phase that counts the remaining minor and major pieces, so evaluating only
+ * blends the two sums.
+ */
+namespace Eval {
+	void init();
+
+	// Phase of the starting material: 1 per minor piece, 2 per rook, 4 per queen
+	constexpr int MAX_PHASE = 24;
+	constexpr int PHASE_WEIGHTS[PIECE_KIND_NB] = { 0, 1, 1, 2, 4, 0 };
+
+	// Plain material, for exchange evaluation and pruning margins rather than scoring
+	constexpr int PIECE_VALUES[PIECE_KIND_NB] = { 100, 320, 330, 500, 900, 0 };
+
+	extern int16_t midgame[PIECE_NB][SQUARE_NB];
+	extern int16_t endgame[PIECE_NB][SQUARE_NB];
+
+	/**
+	 * @brief  Blends the midgame and endgame sums by phase, capped at MAX_PHASE after early promotions.
+	 */
+	inline int taper(int midgameScore, int endgameScore, int phase) {
+		if (phase > MAX_PHASE) phase = MAX_PHASE;
+		return (midgameScore * phase + endgameScore * (MAX_PHASE - phase)) / MAX_PHASE;
+	}
+}
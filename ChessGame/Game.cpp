@@ -1,17 +1,70 @@
 #include "Game.h"
 
+#include <cstdio>
+
+namespace {
+	// Blitz: three minutes a side plus two seconds per move
+	constexpr int64_t CLOCK_START_MS = 3 * 60 * 1000;
+	constexpr int64_t CLOCK_INCREMENT_MS = 2000;
+
+	// A cached analysis at least this deep is played without asking the engine,
+	// until Stockfish has shown how deep it gets on the clock
+	constexpr int CACHE_MIN_DEPTH = 20;
+
+	// Longest the engine may think before it is told to play its best move so far
+	constexpr int64_t STOCKFISH_TIMEOUT_MS = 30000;
+
+	std::string formatClock(int64_t ms) {
+		ms = std::max<int64_t>(ms, 0);
+		char text[32];
+		std::snprintf(text, sizeof(text), "%d:%02d.%d", static_cast<int>(ms / 60000), static_cast<int>(ms / 1000 % 60), static_cast<int>(ms / 100 % 10));
+		return text;
+	}
+}
+
 /**
  * @brief  Initializes the game window and state variables.
  */
 Game::Game() :
 	window(sf::VideoMode({ 1200, 1200 }), "Chess Game", sf::Style::Close),
 	isWhiteTurn(true),
-	fullMoveCount(1),
-	halfMoveClock(0),
+	clockMs{ CLOCK_START_MS, CLOCK_START_MS },
 	selectedPiece(nullptr),
-	enPassantTarget("-"),
-	stockfish("stockfish.exe")
+	stockfish("stockfish.exe"),
+	cacheMinDepth(CACHE_MIN_DEPTH)
 {
+	engine.setThreads(static_cast<int>(std::max(1u, std::thread::hardware_concurrency())));
+	stockfish.newGame();
+	analysisCache.open("analysis.cache");
+	if (PolyglotBook::loadRandomTable("polyglot_random64.txt")) {
+		openingBook.open("book.bin");
+	}
+	else {
+		std::cout << "No opening book: polyglot_random64.txt is missing or is not the Polyglot Random64 table\n";
+	}
+	if (Nnue::load("nnue.bin")) {
+		std::cout << "NNUE evaluation (" << Nnue::simdName(Nnue::getSimdLevel()) << ")\n";
+	}
+
+	// Live analysis of the main line, printed as the engine deepens
+	stockfish.setInfoCallback([](const Uci::Info& info) {
+		if (info.multipv != 1 || info.pv.empty() || !info.hasScore || info.lowerBound || info.upperBound) return;
+		std::cout << "depth " << info.depth << " score " << (info.isMate ? "mate " : "cp ") << info.score
+			<< " nodes " << info.nodes << " nps " << info.nps << " pv " << info.pv << "\n";
+	});
+
+	// The clock starts once everything is loaded
+	turnStart = std::chrono::steady_clock::now();
+}
+
+/**
+ * @brief  Stops any search in progress so closing the window never waits on an engine.
+ */
+Game::~Game() {
+	engine.stop();
+	if (engineRequest) engineRequest->stop();
+	if (ponderRequest) ponderRequest->stop();
+	if (stoppingRequest) stoppingRequest->stop();
 }
 
 /**
@@ -24,19 +77,66 @@ void Game::run() {
 		while (std::optional<sf::Event> event = window.pollEvent()) {
 			handleEvents(event, isRunning);
 		}
+		checkFlag();
 
 		// If it's black's turn and we're not waiting for Stockfish, start async move generation
-		if (!isWhiteTurn && !isAwaitingStockfish) {
-			std::string fen = chessBoard.generateFEN(isWhiteTurn, halfMoveClock, fullMoveCount);
-			stockfishFuture = std::async(std::launch::async, &Stockfish::getBestMoves, &stockfish, fen, 3); // 3 best moves
+		bool isEngineToMove = !isWhiteTurn && !isAwaitingStockfish && status == GameStatus::ONGOING;
+		UciAnalysis cached;
+		Move bookMove = isEngineToMove ? openingBook.probe(chessBoard.getPosition()) : NO_MOVE;
+		if (bookMove != NO_MOVE) {
+			stopPondering();
+			std::cout << "Book move " << Position::moveToUci(bookMove) << "\n";
+			playMove(bookMove);
+		}
+		else if (isEngineToMove && analysisCache.lookup(chessBoard.getHash(), 3, cacheMinDepth, cached)) {
+			// Analysed before at least as deeply: play it without asking the engine
+			stopPondering();
+			std::cout << "From analysis cache (depth " << cached.depth << ")\n";
+			playStockfishAnalysis(cached);
+		}
+		else if (isEngineToMove) {
+			std::string fen = chessBoard.generateFEN();
+			UciLimits limits = clockLimits();
+			if (stockfish.isRunning()) {
+				if (ponderRequest && ponderRequest->getPonderMove() == Position::moveToUci(lastHumanMove)) {
+					// The engine predicted this move and has been thinking about it already
+					ponderRequest->ponderhit();
+					engineRequest = std::move(ponderRequest);
+				}
+				else {
+					// The search on the wrong move is stopped in the background before this one starts
+					stopPondering();
+					engineRequest = EngineRequest::search(stockfish, fen, 3, limits, std::min(STOCKFISH_TIMEOUT_MS, timeLeft(BLACK)), std::move(stoppingRequest)); // 3 best moves
+				}
+			}
+			else {
+				SearchLimits searchLimits;
+				searchLimits.whiteTimeMs = limits.whiteTimeMs;
+				searchLimits.blackTimeMs = limits.blackTimeMs;
+				searchLimits.whiteIncrementMs = limits.whiteIncrementMs;
+				searchLimits.blackIncrementMs = limits.blackIncrementMs;
+				searchLimits.gameKeys = chessBoard.previousKeys();
+				engine.setLimits(searchLimits);
+				engineFuture = std::async(std::launch::async, &Search::getBestMoves, &engine, fen, 3);
+			}
 			isAwaitingStockfish = true;
 		}
 
 		// If Stockfish has returned a move, apply it
-		if (isAwaitingStockfish && stockfishFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-			std::vector<std::string> moves = stockfishFuture.get();
+		if (isAwaitingStockfish && engineRequest && engineRequest->isDone()) {
+			UciAnalysis analysis = engineRequest->get();
+			engineRequest.reset();
+			analysisCache.store(chessBoard.getHash(), 3, analysis);
+			if (analysis.completed && analysis.depth > 0) cacheMinDepth = analysis.depth;
+			playStockfishAnalysis(analysis);
+			isAwaitingStockfish = false;
+		}
+		else if (isAwaitingStockfish && engineFuture.valid() && engineFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+			std::vector<std::string> moves = engineFuture.get();
+			const SearchResult& result = engine.getLastResult();
+			std::cout << "Built-in engine depth " << result.depth << ", " << result.nodes << " nodes, " << result.nps << " nps\n";
 			if (!moves.empty()) {
-				std::cout << "Stockfish recommends:\n";
+				std::cout << "Built-in engine recommends:\n";
 				for (const auto& move : moves) {
 					std::cout << move << std::endl;
 				}
@@ -46,10 +146,7 @@ void Game::run() {
 		}
 
 		window.clear();
-		chessBoard.draw(window, selectedPiece);
-		if (selectedPiece) {
-			window.draw(*selectedPiece);
-		}
+		boardView.draw(window, chessBoard, selectedPiece, dragPosition);
 		window.display();
 	}
 }
@@ -73,7 +170,7 @@ void Game::handleEvents(const std::optional<sf::Event>& event, bool& isRuning) {
 	}
 	else if (const auto* mouseMoved = event->getIf<sf::Event::MouseMoved>()) {
 		if (selectedPiece) {
-			selectedPiece->setPosition(sf::Vector2f(mouseMoved->position.x - dragOffset.x, mouseMoved->position.y - dragOffset.y));
+			dragPosition = sf::Vector2f(mouseMoved->position.x - dragOffset.x, mouseMoved->position.y - dragOffset.y);
 		}
 	}
 }
@@ -85,10 +182,12 @@ void Game::onPieceClicked(const sf::Event::MouseButtonPressed* mouseButtonPresse
 	int col = mouseButtonPressed->position.x / SQUARE_SIZE;
 	int row = mouseButtonPressed->position.y / SQUARE_SIZE;
 
+	if (status != GameStatus::ONGOING) return;
+
 	if (auto piece = chessBoard.getPiece({ row, col }); piece && piece->isWhite() == isWhiteTurn) {
 		selectedPiece = piece;
-		origianlPosition = selectedPiece->getPosition();
-		dragOffset = { mouseButtonPressed->position.x - selectedPiece->getPosition().x, mouseButtonPressed->position.y - selectedPiece->getPosition().y };
+		dragPosition = BoardView::squareToPixels(piece->getSquare());
+		dragOffset = { mouseButtonPressed->position.x - dragPosition.x, mouseButtonPressed->position.y - dragPosition.y };
 	}
 }
 
@@ -103,68 +202,122 @@ void Game::onPieceReleased(const sf::Event::MouseButtonReleased* mouseButtonRele
 	Square newSquare = { newRow, newCol };
 
 	if (selectedPiece) {
-		Square oldSquare = selectedPiece->getSquare();
-
-		auto isValidMove = [&](const Square& pos) {
-			auto legalMoves = chessBoard.getLegalMoves(selectedPiece);
-			return std::find(legalMoves.begin(), legalMoves.end(), pos) != legalMoves.end();
-			};
-
-		if (isValidMove(newSquare)) {
-
-			chessBoard.movePiece(oldSquare, newSquare);
-
-			if (!isWhiteTurn) {
-				fullMoveCount++;
-			}
-			isWhiteTurn = !isWhiteTurn;
-			if (chessBoard.isCheckMate(isWhiteTurn)) {
-				std::cout << "Checkmate!";
-			}
-		}
-		else {
-			selectedPiece->setPosition(origianlPosition);
+		MoveList legalMoves = chessBoard.getLegalMoves(selectedPiece);
+		const Move* move = std::find_if(legalMoves.begin(), legalMoves.end(), [&](Move legalMove) {
+			return legalMove.to() == squareIndex(newSquare);
+			});
+
+		if (move != legalMoves.end()) {
+			lastHumanMove = *move;
+			playMove(*move);
 		}
 	}
 
 	selectedPiece = nullptr;
 }
 
-void Game::applyStockfishMove(const std::string& move) {
-	if (move.length() < 4) {
+/**
+ * @brief  Plays the best line of a Stockfish analysis, then ponders on the expected reply.
+ */
+void Game::playStockfishAnalysis(const UciAnalysis& analysis) {
+	if (analysis.lines.empty()) {
 		return;
 	}
 
-	Square from = chessBoard.literalToSquare(move.substr(0, 2));
-	Square to = chessBoard.literalToSquare(move.substr(2, 2));
-
-	chessBoard.movePiece(from, to);
-
-	if (!isWhiteTurn) {
-		fullMoveCount++;
+	std::cout << "Stockfish recommends:\n";
+	for (const UciLine& line : analysis.lines) {
+		std::cout << line.move << std::endl;
 	}
-	isWhiteTurn = !isWhiteTurn;
+	applyStockfishMove(analysis.lines[0].move); // play best move
 
-	if (chessBoard.isCheckMate(isWhiteTurn)) {
-		std::cout << "Checkmate!\n";
+	// Think on the expected reply while the player is moving
+	if (isWhiteTurn && !analysis.ponderMove.empty() && stockfish.isRunning()) {
+		std::string fen = chessBoard.generateFEN();
+		ponderRequest = EngineRequest::ponder(stockfish, fen, analysis.ponderMove, 3, clockLimits(), std::min(STOCKFISH_TIMEOUT_MS, timeLeft(BLACK)), std::move(stoppingRequest));
 	}
 }
 
-
-void Game::runStockfish(const std::string& fen, int n) {
-	std::vector<std::string> bestMoves = stockfish.getBestMoves(fen, n);
-
-	std::cout << "Stockfish recommends:\n";
-	for (const auto& move : bestMoves) {
-		std::cout << move << std::endl;
-	}
+/**
+ * @brief  Plays a move given in UCI notation by an engine. Illegal or malformed moves are ignored.
+ */
+void Game::applyStockfishMove(const std::string& move) {
+	playMove(chessBoard.getPosition().findUciMove(move));
 }
 
+/**
+ * @brief  Plays a legal move for the side to move, records it in the game history and hands the clock over.
+ *
+ * The mover's clock is charged for the time since its turn started and
+ * credited the increment. A move made after the flag fell is not played.
+ */
+void Game::playMove(Move move) {
+	if (status != GameStatus::ONGOING || checkFlag() || !chessBoard.makeMove(move)) {
+		return;
+	}
+	int mover = isWhiteTurn ? WHITE : BLACK;
+	clockMs[mover] = timeLeft(mover) + CLOCK_INCREMENT_MS;
+	turnStart = std::chrono::steady_clock::now();
+	std::cout << "White " << formatClock(clockMs[WHITE]) << "  Black " << formatClock(clockMs[BLACK]) << "\n";
 
+	isWhiteTurn = !isWhiteTurn;
 
+	status = chessBoard.gameStatus();
+	switch (status) {
+	case GameStatus::CHECKMATE: std::cout << "Checkmate!\n"; break;
+	case GameStatus::STALEMATE: std::cout << "Stalemate!\n"; break;
+	case GameStatus::THREEFOLD_REPETITION: std::cout << "Draw by threefold repetition\n"; break;
+	case GameStatus::FIFTY_MOVE_RULE: std::cout << "Draw by the fifty-move rule\n"; break;
+	case GameStatus::INSUFFICIENT_MATERIAL: std::cout << "Draw by insufficient material\n"; break;
+	default: break;
+	}
+}
 
+/**
+ * @brief  Milliseconds `color` has left, counting the time since its turn started if it is to move.
+ */
+int64_t Game::timeLeft(int color) const {
+	int64_t left = clockMs[color];
+	if ((color == WHITE) == isWhiteTurn) {
+		left -= std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - turnStart).count();
+	}
+	return left;
+}
 
+/**
+ * @brief  Ends the game if the side to move has run out of time, stopping any engine search. True once a flag has fallen.
+ */
+bool Game::checkFlag() {
+	if (status == GameStatus::TIME_FORFEIT) return true;
+	if (status != GameStatus::ONGOING || timeLeft(isWhiteTurn ? WHITE : BLACK) > 0) return false;
+
+	status = GameStatus::TIME_FORFEIT;
+	std::cout << (isWhiteTurn ? "White" : "Black") << " loses on time\n";
+	engine.stop();
+	if (engineRequest) engineRequest->stop();
+	stopPondering();
+	return true;
+}
 
+/**
+ * @brief  Stops the ponder search without waiting for its bestmove, which can take the engine's whole grace period.
+ *
+ * The stopped request is kept in stoppingRequest and handed to the next
+ * engine request, whose worker thread waits for it instead of the render loop.
+ */
+void Game::stopPondering() {
+	if (!ponderRequest) return;
+	ponderRequest->stop();
+	stoppingRequest = std::move(ponderRequest);
+}
 
-
-
+/**
+ * @brief  Both clocks as they stand now, for an engine to budget its own time.
+ */
+UciLimits Game::clockLimits() const {
+	UciLimits limits;
+	limits.whiteTimeMs = std::max<int64_t>(timeLeft(WHITE), 1);
+	limits.blackTimeMs = std::max<int64_t>(timeLeft(BLACK), 1);
+	limits.whiteIncrementMs = CLOCK_INCREMENT_MS;
+	limits.blackIncrementMs = CLOCK_INCREMENT_MS;
+	return limits;
+}
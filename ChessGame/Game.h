@@ -5,39 +5,62 @@
 #include <iostream>
 #include <string>
 #include <sstream> 
+#include <chrono>
 #include <future>
+#include <thread>
 
+#include "AnalysisCache.h"
+#include "BoardView.h"
 #include "ChessBoard.h"
+#include "EngineRequest.h"
 #include "Piece.h"
+#include "PolyglotBook.h"
+#include "Search.h"
 #include "Stockfish.h"
 
 class Game {
 public:
     Game();
+    ~Game();
     void run();
 
 private:
     ChessBoard chessBoard;
+    BoardView boardView;
     sf::RenderWindow window;
 
-    int fullMoveCount;
-    int halfMoveClock;
     bool isWhiteTurn;
-    std::string enPassantTarget;
+    GameStatus status = GameStatus::ONGOING;  // Anything else ends the game
 
-    Piece* selectedPiece;
+    // Milliseconds left on each side's clock when its turn started; the side to move's runs from turnStart
+    int64_t clockMs[2];
+    std::chrono::steady_clock::time_point turnStart;
+
+    const Piece* selectedPiece;
     sf::Vector2f dragOffset;
-    sf::Vector2f origianlPosition;
+    sf::Vector2f dragPosition;
 
     void handleEvents(const std::optional<sf::Event>& event, bool& isRunning);
     void onPieceClicked(const sf::Event::MouseButtonPressed* mouseButtonPressed);
     void onPieceReleased(const sf::Event::MouseButtonReleased* mouseButtonReleased);
+    void playStockfishAnalysis(const UciAnalysis& analysis);
     void applyStockfishMove(const std::string& move);
-
-    void runStockfish(const std::string& fen, int n);
+    void playMove(Move move);
+    int64_t timeLeft(int color) const;
+    bool checkFlag();
+    UciLimits clockLimits() const;
+    void stopPondering();
 
     Stockfish stockfish;
-    std::future<std::vector<std::string>> stockfishFuture;
+    Search engine; // Built-in fallback when no external engine could be started
+    std::future<std::vector<std::string>> engineFuture;  // Built-in engine search
+    std::unique_ptr<EngineRequest> engineRequest;  // Stockfish search for the move to play
+    std::unique_ptr<EngineRequest> ponderRequest;  // Stockfish thinking on the expected reply
+    std::unique_ptr<EngineRequest> stoppingRequest;  // Stopped ponder search the next request waits for
+    Move lastHumanMove = NO_MOVE;
+    PolyglotBook openingBook;  // book.bin, probed before the engine is asked
+    AnalysisCache analysisCache;  // Earlier Stockfish results, persisted in analysis.cache
+    int cacheMinDepth;  // Depth Stockfish reached on its last move; a cached analysis this deep replaces a search
     bool isAwaitingStockfish = false;
 };
 
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#if defined(_WIN32)
+#include <windows.h>
+#endif
+
+/**
+ * @brief  Read-only memory mapping of a whole file.
+ *
+ * Pages are loaded by the OS on first access and shared between processes
+ * mapping the same file, so opening a large file is cheap and nothing is
+ * copied onto the heap. The mapping does not follow later growth of the
+ * file; call open() again to see appended data.
+ */
+class MappedFile {
+public:
+	MappedFile() = default;
+	~MappedFile() {
+		close();
+	}
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool open(const std::string& path);
+	void close();
+
+	const uint8_t* data() const {
+		return mappedData;
+	}
+	size_t size() const {
+		return mappedSize;
+	}
+
+private:
+#if defined(_WIN32)
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = NULL;
+#endif
+	const uint8_t* mappedData = nullptr;
+	size_t mappedSize = 0;
+};
@@ -0,0 +1,133 @@
+#include "MovePicker.h"
+
+#include <utility>
+
+#include "Evaluation.h"
+
+MovePicker::MovePicker(const Position& position, Move ttMove, const Move* killers, Move counterMove, const ButterflyHistory& history)
+	: position(position), history(&history), stage(Stage::TT_MOVE), ttMove(ttMove), killers{ killers[0], killers[1] }, counterMove(counterMove) {
+	if (!position.isLegal(ttMove)) this->ttMove = NO_MOVE;
+}
+
+MovePicker::MovePicker(const Position& position)
+	: position(position), history(nullptr), stage(Stage::QS_GENERATE), ttMove(NO_MOVE), killers{ NO_MOVE, NO_MOVE }, counterMove(NO_MOVE) {
+}
+
+/**
+ * @brief  The next move to search, or NO_MOVE once every move has been handed out.
+ */
+Move MovePicker::next() {
+	while (true) {
+		switch (stage) {
+		case Stage::TT_MOVE:
+			stage = Stage::GENERATE_TACTICAL;
+			if (ttMove != NO_MOVE) return ttMove;
+			break;
+
+		case Stage::GENERATE_TACTICAL:
+		case Stage::QS_GENERATE:
+			end = position.generateLegalMoves(moves, MoveGenType::TACTICAL);
+			scoreTactical();
+			stage = stage == Stage::QS_GENERATE ? Stage::QS_TACTICAL : Stage::GOOD_TACTICAL;
+			break;
+
+		case Stage::GOOD_TACTICAL:
+		case Stage::QS_TACTICAL:
+			while (cursor < end) {
+				Move move = pickBest();
+				if (move == ttMove) continue;
+				bool underpromotion = move.flag() == MoveFlag::PROMOTION && move.promotion() != QUEEN;
+				if (underpromotion || position.see(move) < 0) {
+					if (stage == Stage::GOOD_TACTICAL) moves[badEnd++] = move;
+					continue;
+				}
+				return move;
+			}
+			if (stage == Stage::QS_TACTICAL) {
+				stage = Stage::DONE;
+				break;
+			}
+			stage = Stage::KILLER_1;
+			break;
+
+		case Stage::KILLER_1:
+		case Stage::KILLER_2: {
+			Move killer = killers[stage == Stage::KILLER_1 ? 0 : 1];
+			stage = stage == Stage::KILLER_1 ? Stage::KILLER_2 : Stage::COUNTER_MOVE;
+			if (killer != NO_MOVE && killer != ttMove && !position.isTactical(killer) && position.isLegal(killer)) return killer;
+			break;
+		}
+
+		case Stage::COUNTER_MOVE:
+			stage = Stage::GENERATE_QUIETS;
+			if (counterMove != NO_MOVE && counterMove != ttMove && counterMove != killers[0] && counterMove != killers[1]
+				&& !position.isTactical(counterMove) && position.isLegal(counterMove)) {
+				return counterMove;
+			}
+			break;
+
+		case Stage::GENERATE_QUIETS:
+			// Quiet moves go after the tactical ones, wherever the losing captures ended up
+			cursor = end;
+			end += position.generateLegalMoves(moves + cursor, MoveGenType::QUIET);
+			scoreQuiets();
+			stage = Stage::QUIETS;
+			break;
+
+		case Stage::QUIETS:
+			while (cursor < end) {
+				Move move = pickBest();
+				if (!isSpecial(move)) return move;
+			}
+			stage = Stage::BAD_TACTICAL;
+			break;
+
+		case Stage::BAD_TACTICAL:
+			if (badCursor < badEnd) return moves[badCursor++];
+			stage = Stage::DONE;
+			break;
+
+		case Stage::DONE:
+			return NO_MOVE;
+		}
+	}
+}
+
+/**
+ * @brief  MVV-LVA: the most valuable victim first, and among equal victims the cheapest attacker.
+ */
+void MovePicker::scoreTactical() {
+	for (int i = 0; i < end; ++i) {
+		Move move = moves[i];
+		int victim = move.flag() == MoveFlag::EN_PASSANT ? PAWN : position.pieceOn(move.to()) == NO_PIECE ? -1 : kindOf(position.pieceOn(move.to()));
+		int score = victim >= 0 ? Eval::PIECE_VALUES[victim] * 8 - kindOf(position.pieceOn(move.from())) : 0;
+		if (move.flag() == MoveFlag::PROMOTION) score += Eval::PIECE_VALUES[move.promotion()];
+		scores[i] = score;
+	}
+}
+
+void MovePicker::scoreQuiets() {
+	int us = static_cast<int>(position.sideToMove());
+	for (int i = cursor; i < end; ++i) scores[i] = (*history)[us][moves[i].from()][moves[i].to()];
+}
+
+/**
+ * @brief  Swaps the best-scored remaining move to the cursor and returns it.
+ *
+ * A selection step rather than a full sort, since most nodes cut off
+ * after the first few moves.
+ */
+Move MovePicker::pickBest() {
+	int best = cursor;
+	for (int i = cursor + 1; i < end; ++i) {
+		if (scores[i] > scores[best]) best = i;
+	}
+	std::swap(moves[best], moves[cursor]);
+	std::swap(scores[best], scores[cursor]);
+	return moves[cursor++];
+}
+
+// Quiet moves already handed out by an earlier stage
+bool MovePicker::isSpecial(Move move) const {
+	return move == ttMove || move == killers[0] || move == killers[1] || move == counterMove;
+}
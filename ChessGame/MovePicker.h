@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Position.h"
+
+// Quiet-move scores by [colour][from][to], kept within +-HISTORY_MAX
+constexpr int HISTORY_MAX = 16384;
+using ButterflyHistory = int16_t[2][SQUARE_NB][SQUARE_NB];
+
+/**
+ * @brief  Hands out the legal moves of a position one at a time, likeliest cutoff first.
+ *
+ * Moves come in stages: the transposition table move, captures and
+ * promotions that do not lose material by MVV-LVA, the two killer moves, the
+ * countermove, the remaining quiet moves by history score, and finally the
+ * losing captures and underpromotions. Each stage is only generated once
+ * the previous ones are exhausted, so when an early move causes a cutoff
+ * the quiet moves are never generated at all. Moves from the table, killer
+ * and countermove slots are checked with Position::isLegal and never handed
+ * out twice.
+ *
+ * The quiescence constructor yields only captures and queen promotions
+ * that do not lose material.
+ */
+class MovePicker {
+public:
+	MovePicker(const Position& position, Move ttMove, const Move* killers, Move counterMove, const ButterflyHistory& history);
+	explicit MovePicker(const Position& position);
+
+	Move next();
+
+private:
+	enum class Stage : uint8_t {
+		TT_MOVE,
+		GENERATE_TACTICAL,
+		GOOD_TACTICAL,
+		KILLER_1,
+		KILLER_2,
+		COUNTER_MOVE,
+		GENERATE_QUIETS,
+		QUIETS,
+		BAD_TACTICAL,
+		QS_GENERATE,
+		QS_TACTICAL,
+		DONE
+	};
+
+	void scoreTactical();
+	void scoreQuiets();
+	Move pickBest();
+	bool isSpecial(Move move) const;
+
+	const Position& position;
+	const ButterflyHistory* history;
+	Stage stage;
+	Move ttMove;
+	Move killers[2];
+	Move counterMove;
+
+	// Tactical moves fill the front of the buffer and quiet moves follow them.
+	// Losing captures are moved back over the tactical entries already handed out.
+	Move moves[MAX_MOVES];
+	int scores[MAX_MOVES];
+	int cursor = 0;
+	int end = 0;
+	int badEnd = 0;
+	int badCursor = 0;
+};
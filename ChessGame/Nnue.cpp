@@ -0,0 +1,292 @@
+#include "Nnue.h"
+
+#include <cstring>
+
+#include "MappedFile.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NNUE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define TARGET_SSE2
+#define TARGET_AVX2
+#else
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+	constexpr char MAGIC[8] = { 'C', 'G', 'N', 'N', 'U', 'E', '0', '1' };
+
+	/*
+	 * The two inner loops, once per instruction set. applyChanges writes
+	 * `in` plus the added rows minus the removed rows to `out`, which may be
+	 * `in` itself; output clips both accumulator halves and takes their dot
+	 * product with the output weights.
+	 */
+	struct Kernels {
+		void (*applyChanges)(int16_t* out, const int16_t* in, const int16_t* const* added, int addCount, const int16_t* const* removed, int removeCount);
+		int32_t (*output)(const int16_t* us, const int16_t* them, const int16_t* weights);
+	};
+
+	void applyChangesScalar(int16_t* out, const int16_t* in, const int16_t* const* added, int addCount, const int16_t* const* removed, int removeCount) {
+		for (int i = 0; i < Nnue::HIDDEN; ++i) {
+			int value = in[i];
+			for (int a = 0; a < addCount; ++a) value += added[a][i];
+			for (int r = 0; r < removeCount; ++r) value -= removed[r][i];
+			out[i] = static_cast<int16_t>(value);
+		}
+	}
+
+	int32_t clipped(int16_t value) {
+		return value < 0 ? 0 : value > Nnue::QA ? Nnue::QA : value;
+	}
+
+	int32_t outputScalar(const int16_t* us, const int16_t* them, const int16_t* weights) {
+		int32_t sum = 0;
+		for (int i = 0; i < Nnue::HIDDEN; ++i) {
+			sum += clipped(us[i]) * weights[i] + clipped(them[i]) * weights[Nnue::HIDDEN + i];
+		}
+		return sum;
+	}
+
+#if defined(NNUE_X86)
+	TARGET_SSE2 void applyChangesSse2(int16_t* out, const int16_t* in, const int16_t* const* added, int addCount, const int16_t* const* removed, int removeCount) {
+		for (int i = 0; i < Nnue::HIDDEN; i += 8) {
+			__m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+			for (int a = 0; a < addCount; ++a) value = _mm_add_epi16(value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(added[a] + i)));
+			for (int r = 0; r < removeCount; ++r) value = _mm_sub_epi16(value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(removed[r] + i)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), value);
+		}
+	}
+
+	TARGET_SSE2 int32_t outputSse2(const int16_t* us, const int16_t* them, const int16_t* weights) {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i qa = _mm_set1_epi16(Nnue::QA);
+		__m128i sum = zero;
+		for (int i = 0; i < Nnue::HIDDEN; i += 8) {
+			__m128i ours = _mm_min_epi16(_mm_max_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(us + i)), zero), qa);
+			__m128i theirs = _mm_min_epi16(_mm_max_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(them + i)), zero), qa);
+			sum = _mm_add_epi32(sum, _mm_madd_epi16(ours, _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + i))));
+			sum = _mm_add_epi32(sum, _mm_madd_epi16(theirs, _mm_loadu_si128(reinterpret_cast<const __m128i*>(weights + Nnue::HIDDEN + i))));
+		}
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+		sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+		return _mm_cvtsi128_si32(sum);
+	}
+
+	TARGET_AVX2 void applyChangesAvx2(int16_t* out, const int16_t* in, const int16_t* const* added, int addCount, const int16_t* const* removed, int removeCount) {
+		for (int i = 0; i < Nnue::HIDDEN; i += 16) {
+			__m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+			for (int a = 0; a < addCount; ++a) value = _mm256_add_epi16(value, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(added[a] + i)));
+			for (int r = 0; r < removeCount; ++r) value = _mm256_sub_epi16(value, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(removed[r] + i)));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), value);
+		}
+	}
+
+	TARGET_AVX2 int32_t outputAvx2(const int16_t* us, const int16_t* them, const int16_t* weights) {
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i qa = _mm256_set1_epi16(Nnue::QA);
+		__m256i sum = zero;
+		for (int i = 0; i < Nnue::HIDDEN; i += 16) {
+			__m256i ours = _mm256_min_epi16(_mm256_max_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(us + i)), zero), qa);
+			__m256i theirs = _mm256_min_epi16(_mm256_max_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(them + i)), zero), qa);
+			sum = _mm256_add_epi32(sum, _mm256_madd_epi16(ours, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + i))));
+			sum = _mm256_add_epi32(sum, _mm256_madd_epi16(theirs, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(weights + Nnue::HIDDEN + i))));
+		}
+		__m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+		half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+		half = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+		return _mm_cvtsi128_si32(half);
+	}
+#endif
+
+	Kernels kernelsFor(Nnue::SimdLevel level) {
+#if defined(NNUE_X86)
+		if (level == Nnue::SimdLevel::AVX2) return { applyChangesAvx2, outputAvx2 };
+		if (level == Nnue::SimdLevel::SSE2) return { applyChangesSse2, outputSse2 };
+#endif
+		return { applyChangesScalar, outputScalar };
+	}
+
+	Nnue::SimdLevel activeLevel = Nnue::detectSimd();
+	Kernels kernels = kernelsFor(activeLevel);
+
+	MappedFile networkFile;
+	const int16_t* featureWeights = nullptr;
+	const int16_t* featureBiases = nullptr;
+	const int16_t* outputWeights = nullptr;
+	int32_t outputBias = 0;
+	uint32_t currentNetwork = 0;
+	uint32_t loadCount = 0;
+
+	// Black sees the board with colours swapped and ranks mirrored, so both halves share one set of weights
+	const int16_t* featureRow(int perspective, int piece, int square) {
+		if (perspective == BLACK) {
+			piece = makePiece(colorOf(piece) ^ 1, kindOf(piece));
+			square ^= 56;
+		}
+		return featureWeights + (static_cast<size_t>(piece) * SQUARE_NB + square) * Nnue::HIDDEN;
+	}
+}
+
+/**
+ * @brief  Maps a network file and makes it the one every evaluation uses.
+ *
+ * The file must be exactly FILE_SIZE bytes with a matching header. On
+ * failure no network is loaded and callers fall back to the handcrafted
+ * evaluation.
+ */
+bool Nnue::load(const std::string& path) {
+	currentNetwork = 0;
+	featureWeights = featureBiases = outputWeights = nullptr;
+	networkFile.close();
+	if (!networkFile.open(path)) return false;
+
+	FileHeader header;
+	if (networkFile.size() != FILE_SIZE) return false;
+	std::memcpy(&header, networkFile.data(), sizeof(header));
+	if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.hidden != HIDDEN) return false;
+
+	featureWeights = reinterpret_cast<const int16_t*>(networkFile.data() + sizeof(FileHeader));
+	featureBiases = featureWeights + static_cast<size_t>(INPUTS) * HIDDEN;
+	outputWeights = featureBiases + HIDDEN;
+	std::memcpy(&outputBias, outputWeights + 2 * HIDDEN, sizeof(outputBias));
+	currentNetwork = ++loadCount;
+	return true;
+}
+
+bool Nnue::isLoaded() {
+	return currentNetwork != 0;
+}
+
+/**
+ * @brief  Changes with every successful load(), so accumulators can tell they are stale.
+ */
+uint32_t Nnue::networkId() {
+	return currentNetwork;
+}
+
+/**
+ * @brief  The widest instruction set this CPU and OS support.
+ */
+Nnue::SimdLevel Nnue::detectSimd() {
+#if defined(NNUE_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+	int info[4];
+	__cpuid(info, 0);
+	int maxLeaf = info[0];
+	__cpuid(info, 1);
+	bool osSavesAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+	if (maxLeaf >= 7 && osSavesAvx) {
+		__cpuidex(info, 7, 0);
+		if (info[1] & (1 << 5)) return SimdLevel::AVX2;
+	}
+	return SimdLevel::SSE2;
+#else
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+	return __builtin_cpu_supports("sse2") ? SimdLevel::SSE2 : SimdLevel::SCALAR;
+#endif
+#else
+	return SimdLevel::SCALAR;
+#endif
+}
+
+Nnue::SimdLevel Nnue::getSimdLevel() {
+	return activeLevel;
+}
+
+/**
+ * @brief  Switches the inner loops to `level`, or to the best supported one below it.
+ *
+ * All levels give identical results; this is for benchmarking them.
+ */
+void Nnue::setSimdLevel(SimdLevel level) {
+	SimdLevel supported = detectSimd();
+	activeLevel = static_cast<int>(level) > static_cast<int>(supported) ? supported : level;
+	kernels = kernelsFor(activeLevel);
+}
+
+const char* Nnue::simdName(SimdLevel level) {
+	switch (level) {
+	case SimdLevel::AVX2: return "avx2";
+	case SimdLevel::SSE2: return "sse2";
+	default: return "scalar";
+	}
+}
+
+/**
+ * @brief  Computes both accumulator halves from scratch.
+ */
+void Nnue::refresh(Accumulator& accumulator, const Position& position) {
+	for (int perspective : { WHITE, BLACK }) {
+		const int16_t* rows[SQUARE_NB];
+		int count = 0;
+		Bitboard occupied = position.occupied();
+		while (occupied) {
+			int square = popLsb(occupied);
+			rows[count++] = featureRow(perspective, position.pieceOn(square), square);
+		}
+		kernels.applyChanges(accumulator.values[perspective], featureBiases, rows, count, nullptr, 0);
+	}
+	accumulator.network = currentNetwork;
+}
+
+/**
+ * @brief  Sets `child` to `parent` updated for `move`, which is about to be played on `position`.
+ *
+ * At most two features leave and two arrive: the mover, a captured piece
+ * (beside the target for en passant) and the rook when castling. `child`
+ * and `parent` may be the same accumulator.
+ */
+void Nnue::update(Accumulator& child, const Accumulator& parent, const Position& position, Move move) {
+	int from = move.from(), to = move.to();
+	int piece = position.pieceOn(from);
+	int us = colorOf(piece);
+
+	int addedPieces[2], addedSquares[2], removedPieces[2], removedSquares[2];
+	int addCount = 0, removeCount = 0;
+	auto add = [&](int addedPiece, int square) {
+		addedPieces[addCount] = addedPiece;
+		addedSquares[addCount++] = square;
+	};
+	auto remove = [&](int removedPiece, int square) {
+		removedPieces[removeCount] = removedPiece;
+		removedSquares[removeCount++] = square;
+	};
+
+	remove(piece, from);
+	add(move.flag() == MoveFlag::PROMOTION ? makePiece(us, move.promotion()) : piece, to);
+	if (move.flag() == MoveFlag::EN_PASSANT) {
+		remove(makePiece(us ^ 1, PAWN), squareIndex(rowOf(from), colOf(to)));
+	}
+	else if (position.pieceOn(to) != NO_PIECE) {
+		remove(position.pieceOn(to), to);
+	}
+	if (move.flag() == MoveFlag::CASTLING) {
+		bool kingSide = to > from;
+		int rowStart = squareIndex(rowOf(from), 0);
+		remove(makePiece(us, ROOK), rowStart + (kingSide ? 7 : 0));
+		add(makePiece(us, ROOK), rowStart + (kingSide ? 5 : 3));
+	}
+
+	for (int perspective : { WHITE, BLACK }) {
+		const int16_t* addedRows[2];
+		const int16_t* removedRows[2];
+		for (int i = 0; i < addCount; ++i) addedRows[i] = featureRow(perspective, addedPieces[i], addedSquares[i]);
+		for (int i = 0; i < removeCount; ++i) removedRows[i] = featureRow(perspective, removedPieces[i], removedSquares[i]);
+		kernels.applyChanges(child.values[perspective], parent.values[perspective], addedRows, addCount, removedRows, removeCount);
+	}
+	child.network = parent.network;
+}
+
+/**
+ * @brief  Network score in centipawns from the point of view of `sideToMove`.
+ */
+int Nnue::evaluate(const Accumulator& accumulator, int sideToMove) {
+	int64_t sum = kernels.output(accumulator.values[sideToMove], accumulator.values[sideToMove ^ 1], outputWeights) + static_cast<int64_t>(outputBias);
+	return static_cast<int>(sum * OUTPUT_SCALE / (QA * QB));
+}
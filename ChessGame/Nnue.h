@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "Position.h"
+
+/**
+ * @brief  Efficiently updatable neural network evaluation.
+ *
+ * A 768 -> 2x256 -> 1 network: every piece on every square is an input
+ * feature, seen once from each side's perspective (colours swapped and the
+ * board mirrored for black). The first layer's sums, the accumulator, only
+ * change in the few features a move touches, so they are updated by adding
+ * and subtracting weight rows instead of being recomputed. The output layer
+ * clips both halves to [0, QA], side to move first, and takes one dot
+ * product.
+ *
+ * The inner loops run with AVX2, SSE2 or plain C++, picked at runtime from
+ * what the CPU supports. Weights are memory-mapped from a file; load() is
+ * not thread-safe and must not run during a search.
+ */
+namespace Nnue {
+	constexpr int INPUTS = PIECE_NB * SQUARE_NB;
+	constexpr int HIDDEN = 256;
+
+	// Quantisation: clipped accumulators lie in [0, QA], output weights are scaled by QB
+	constexpr int QA = 255;
+	constexpr int QB = 64;
+	constexpr int OUTPUT_SCALE = 400;
+
+	/**
+	 * @brief  Layout of a network file, all little-endian:
+	 *         header, int16 feature weights [INPUTS][HIDDEN], int16 feature
+	 *         biases [HIDDEN], int16 output weights [2][HIDDEN], int32 output bias.
+	 */
+	struct FileHeader {
+		char magic[8];        // "CGNNUE01"
+		uint32_t hidden;      // Must equal HIDDEN
+		uint32_t reserved[5];
+	};
+	static_assert(sizeof(FileHeader) == 32, "Weights must start 32-byte aligned");
+
+	constexpr size_t FILE_SIZE = sizeof(FileHeader) + (static_cast<size_t>(INPUTS) * HIDDEN + HIDDEN + 2 * HIDDEN) * sizeof(int16_t) + sizeof(int32_t);
+
+	struct alignas(32) Accumulator {
+		int16_t values[2][HIDDEN];  // By perspective colour
+		uint32_t network = 0;       // networkId() it was computed for; 0 if never
+	};
+
+	enum class SimdLevel {
+		SCALAR,
+		SSE2,
+		AVX2
+	};
+
+	bool load(const std::string& path);
+	bool isLoaded();
+	uint32_t networkId();
+
+	SimdLevel detectSimd();
+	SimdLevel getSimdLevel();
+	void setSimdLevel(SimdLevel level);
+	const char* simdName(SimdLevel level);
+
+	void refresh(Accumulator& accumulator, const Position& position);
+	void update(Accumulator& child, const Accumulator& parent, const Position& position, Move move);
+	int evaluate(const Accumulator& accumulator, int sideToMove);
+}
@@ -0,0 +1,117 @@
+#include "Perft.h"
+
+#include <chrono>
+#include <string>
+
+namespace {
+	uint64_t perftRecursive(Position& position, int depth) {
+		Move moves[MAX_MOVES];
+		int count = position.generateLegalMoves(moves);
+		if (depth == 1) return count;
+
+		uint64_t nodes = 0;
+		UndoInfo undo;
+		for (int i = 0; i < count; ++i) {
+			position.makeMove(moves[i], undo);
+			nodes += perftRecursive(position, depth - 1);
+			position.unmakeMove(moves[i], undo);
+		}
+		return nodes;
+	}
+
+	void collectRecursive(Position& position, int depth, std::vector<Position>& positions, size_t limit) {
+		if (positions.size() >= limit) return;
+		positions.push_back(position);
+		if (depth == 0) return;
+
+		Move moves[MAX_MOVES];
+		int count = position.generateLegalMoves(moves);
+		UndoInfo undo;
+		for (int i = 0; i < count; ++i) {
+			position.makeMove(moves[i], undo);
+			collectRecursive(position, depth - 1, positions, limit);
+			position.unmakeMove(moves[i], undo);
+		}
+	}
+
+	double secondsSince(std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+/**
+ * @brief  Counts the leaf nodes of the legal move tree to the given depth.
+ *
+ * The last ply is bulk-counted: the number of legal moves is the number of leaves.
+ */
+uint64_t Perft::perft(const Position& position, int depth) {
+	if (depth < 1) return 1;
+	Position scratch = position;
+	return perftRecursive(scratch, depth);
+}
+
+/**
+ * @brief  Perft that also prints the node count below each root move, for bug hunting.
+ */
+uint64_t Perft::divide(const Position& position, int depth, std::ostream& out) {
+	Move moves[MAX_MOVES];
+	int count = position.generateLegalMoves(moves);
+
+	uint64_t nodes = 0;
+	Position scratch = position;
+	UndoInfo undo;
+	for (int i = 0; i < count; ++i) {
+		scratch.makeMove(moves[i], undo);
+		uint64_t childNodes = depth > 1 ? perftRecursive(scratch, depth - 1) : 1;
+		scratch.unmakeMove(moves[i], undo);
+		out << Position::moveToUci(moves[i]) << ": " << childNodes << "\n";
+		nodes += childNodes;
+	}
+	return nodes;
+}
+
+/**
+ * @brief  Runs every reference position and compares against the known node counts.
+ */
+bool Perft::runReferenceSuite(std::ostream& out) {
+	bool allPassed = true;
+	uint64_t totalNodes = 0;
+	double totalSeconds = 0;
+
+	for (const ReferencePosition& reference : REFERENCE_POSITIONS) {
+		Position position;
+		if (!position.setFromFEN(reference.fen)) {
+			out << reference.name << ": invalid FEN\n";
+			allPassed = false;
+			continue;
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		uint64_t nodes = perft(position, reference.depth);
+		double seconds = secondsSince(start);
+		totalNodes += nodes;
+		totalSeconds += seconds;
+
+		bool passed = nodes == reference.expectedNodes;
+		allPassed = allPassed && passed;
+
+		out << reference.name << " depth " << reference.depth << ": " << nodes << " nodes, "
+			<< static_cast<uint64_t>(nodes / (seconds > 0 ? seconds : 1e-9)) << " nps"
+			<< (passed ? "  OK" : "  FAIL (expected " + std::to_string(reference.expectedNodes) + ")") << "\n";
+	}
+
+	out << "total: " << totalNodes << " nodes in " << totalSeconds << " s, "
+		<< static_cast<uint64_t>(totalNodes / (totalSeconds > 0 ? totalSeconds : 1e-9)) << " nps\n";
+	return allPassed;
+}
+
+/**
+ * @brief  Appends every position of the tree below `position` down to `depth`, parents first.
+ *
+ * Stops once `positions` holds `limit` entries. The evaluation benchmarks
+ * build their samples with it.
+ */
+void Perft::collectPositions(const Position& position, int depth, std::vector<Position>& positions, size_t limit) {
+	Position scratch = position;
+	collectRecursive(scratch, depth, positions, limit);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+#include "Position.h"
+
+namespace Perft {
+	struct ReferencePosition {
+		const char* name;
+		const char* fen;
+		int depth;
+		uint64_t expectedNodes;
+	};
+
+	// Standard positions from the Chess Programming Wiki "Perft Results" page
+	constexpr ReferencePosition REFERENCE_POSITIONS[] = {
+		{ "start",     "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 5, 4865609ULL },
+		{ "kiwipete",  "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4085603ULL },
+		{ "position3", "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 5, 674624ULL },
+		{ "position4", "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 4, 422333ULL },
+		{ "position5", "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487ULL },
+		{ "position6", "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594ULL }
+	};
+
+	uint64_t perft(const Position& position, int depth);
+	uint64_t divide(const Position& position, int depth, std::ostream& out);
+	bool runReferenceSuite(std::ostream& out);
+	void collectPositions(const Position& position, int depth, std::vector<Position>& positions, size_t limit = SIZE_MAX);
+}
@@ -0,0 +1,205 @@
+#include "PolyglotBook.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+
+namespace {
+	constexpr size_t ENTRY_SIZE = 16;
+
+	// Offsets into the Random64 table
+	constexpr int RANDOM_CASTLE = 768;
+	constexpr int RANDOM_EN_PASSANT = 772;
+	constexpr int RANDOM_TURN = 780;
+
+	uint64_t randomTable[PolyglotBook::RANDOM_COUNT];
+	bool randomTableLoaded = false;
+
+	uint64_t readBigEndian(const uint8_t* bytes, int count) {
+		uint64_t value = 0;
+		for (int i = 0; i < count; ++i) value = (value << 8) | bytes[i];
+		return value;
+	}
+
+	// Polyglot orders pieces black pawn, white pawn, black knight, ... and counts ranks from rank 1
+	int randomPieceIndex(int piece, int square) {
+		int polyglotPiece = 2 * kindOf(piece) + (colorOf(piece) == WHITE ? 1 : 0);
+		return 64 * polyglotPiece + 8 * (7 - rowOf(square)) + colOf(square);
+	}
+}
+
+PolyglotBook::PolyglotBook()
+	: entryCount(0), rng(static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()) | 1) {
+}
+
+/**
+ * @brief  Reads the 781 Random64 numbers, in specification order, from a text file.
+ *
+ * Accepts the array as printed in the spec: hex with or without a 0x prefix
+ * and an optional U/ULL suffix, separated by anything else. Returns false,
+ * keeping the previous table, unless the start position then hashes to
+ * START_POSITION_KEY.
+ */
+bool PolyglotBook::loadRandomTable(const std::string& path) {
+	std::ifstream input(path);
+	if (!input) return false;
+	std::string text((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+	uint64_t values[RANDOM_COUNT];
+	int count = 0;
+	for (size_t i = 0; i < text.size() && count < RANDOM_COUNT;) {
+		if (!std::isxdigit(static_cast<unsigned char>(text[i]))) {
+			++i;
+			continue;
+		}
+		if (text[i] == '0' && i + 1 < text.size() && (text[i + 1] == 'x' || text[i + 1] == 'X')) i += 2;
+
+		uint64_t value = 0;
+		int digits = 0;
+		for (; i < text.size() && std::isxdigit(static_cast<unsigned char>(text[i])); ++i, ++digits) {
+			char c = static_cast<char>(std::tolower(static_cast<unsigned char>(text[i])));
+			value = (value << 4) | static_cast<uint64_t>(c <= '9' ? c - '0' : c - 'a' + 10);
+		}
+		if (digits != 16) return false;
+		values[count++] = value;
+		while (i < text.size() && (text[i] == 'u' || text[i] == 'U' || text[i] == 'l' || text[i] == 'L')) ++i;
+	}
+	if (count != RANDOM_COUNT) return false;
+
+	uint64_t previous[RANDOM_COUNT];
+	std::copy(randomTable, randomTable + RANDOM_COUNT, previous);
+	std::copy(values, values + RANDOM_COUNT, randomTable);
+
+	Position start;
+	start.setFromFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+	if (polyglotKey(start) != START_POSITION_KEY) {
+		std::copy(previous, previous + RANDOM_COUNT, randomTable);
+		return false;
+	}
+	randomTableLoaded = true;
+	return true;
+}
+
+bool PolyglotBook::hasRandomTable() {
+	return randomTableLoaded;
+}
+
+/**
+ * @brief  Polyglot hash of a position: pieces, castling rights, en passant file and side to move.
+ *
+ * Position only records an en passant square when a pawn can capture onto
+ * it, which is exactly when Polyglot hashes the file.
+ */
+uint64_t PolyglotBook::polyglotKey(const Position& position) {
+	uint64_t key = 0;
+	Bitboard occupied = position.occupied();
+	while (occupied) {
+		int square = popLsb(occupied);
+		key ^= randomTable[randomPieceIndex(position.pieceOn(square), square)];
+	}
+
+	int castling = position.getCastlingRights();
+	if (castling & WHITE_OO) key ^= randomTable[RANDOM_CASTLE + 0];
+	if (castling & WHITE_OOO) key ^= randomTable[RANDOM_CASTLE + 1];
+	if (castling & BLACK_OO) key ^= randomTable[RANDOM_CASTLE + 2];
+	if (castling & BLACK_OOO) key ^= randomTable[RANDOM_CASTLE + 3];
+
+	if (position.getEnPassantSquare() != NO_SQUARE) key ^= randomTable[RANDOM_EN_PASSANT + colOf(position.getEnPassantSquare())];
+	if (position.sideToMove() == Color::WHITE) key ^= randomTable[RANDOM_TURN];
+	return key;
+}
+
+/**
+ * @brief  Maps a book file. Returns false if it is missing, empty or not a whole number of entries.
+ */
+bool PolyglotBook::open(const std::string& path) {
+	entryCount = 0;
+	if (!file.open(path) || file.size() == 0 || file.size() % ENTRY_SIZE != 0) {
+		file.close();
+		return false;
+	}
+	entryCount = file.size() / ENTRY_SIZE;
+	return true;
+}
+
+PolyglotBook::Entry PolyglotBook::entryAt(size_t index) const {
+	const uint8_t* bytes = file.data() + index * ENTRY_SIZE;
+	return { readBigEndian(bytes, 8), static_cast<uint16_t>(readBigEndian(bytes + 8, 2)), static_cast<uint16_t>(readBigEndian(bytes + 10, 2)) };
+}
+
+size_t PolyglotBook::lowerBound(uint64_t key) const {
+	size_t low = 0, high = entryCount;
+	while (low < high) {
+		size_t middle = low + (high - low) / 2;
+		if (readBigEndian(file.data() + middle * ENTRY_SIZE, 8) < key) low = middle + 1;
+		else high = middle;
+	}
+	return low;
+}
+
+/**
+ * @brief  Picks a book move for `position` at random, in proportion to the entry weights.
+ *
+ * Returns NO_MOVE when the position is not in the book, or when the chosen
+ * entry is not legal here (a hash collision or a corrupt book).
+ */
+Move PolyglotBook::probe(const Position& position) {
+	if (!isOpen() || !randomTableLoaded) return NO_MOVE;
+
+	uint64_t key = polyglotKey(position);
+	size_t first = lowerBound(key);
+	uint32_t totalWeight = 0;
+	size_t last = first;
+	for (; last < entryCount; ++last) {
+		Entry entry = entryAt(last);
+		if (entry.key != key) break;
+		totalWeight += entry.weight;
+	}
+	// Not in the book, or all-zero weights, which mean "never play these"
+	if (totalWeight == 0) return NO_MOVE;
+
+	uint32_t pick = static_cast<uint32_t>(rng.next() % totalWeight);
+	for (size_t i = first; i < last; ++i) {
+		Entry entry = entryAt(i);
+		if (pick < entry.weight) return decodeMove(position, entry.move);
+		pick -= entry.weight;
+	}
+	return NO_MOVE;
+}
+
+/**
+ * @brief  Number of book entries for `position`.
+ */
+int PolyglotBook::countMoves(const Position& position) const {
+	if (!isOpen() || !randomTableLoaded) return 0;
+
+	uint64_t key = polyglotKey(position);
+	int count = 0;
+	for (size_t i = lowerBound(key); i < entryCount && entryAt(i).key == key; ++i) ++count;
+	return count;
+}
+
+/**
+ * @brief  Converts a Polyglot move to a legal Move, or NO_MOVE.
+ *
+ * Polyglot stores castling as the king capturing its own rook (e1h1), which
+ * is turned into the king's two-square step used here.
+ */
+Move PolyglotBook::decodeMove(const Position& position, uint16_t move) {
+	int toCol = move & 7;
+	int toRank = (move >> 3) & 7;
+	int fromCol = (move >> 6) & 7;
+	int fromRank = (move >> 9) & 7;
+	int promotion = (move >> 12) & 7;  // 0 none, 1 knight .. 4 queen
+
+	int from = squareIndex(7 - fromRank, fromCol);
+	int to = squareIndex(7 - toRank, toCol);
+
+	int piece = position.pieceOn(from);
+	if (piece != NO_PIECE && kindOf(piece) == KING && fromCol == 4 && fromRank == toRank && (toCol == 7 || toCol == 0)) {
+		to = squareIndex(7 - toRank, toCol == 7 ? 6 : 2);
+	}
+	return position.findMove(from, to, promotion ? promotion : QUEEN);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "Bitboard.h"
+#include "MappedFile.h"
+#include "Position.h"
+
+/**
+ * @brief  Opening book in the Polyglot .bin format, probed through a memory mapping.
+ *
+ * A book is a sorted array of 16-byte big-endian entries (key, move, weight,
+ * learn). Opening one only maps the file; a probe binary-searches the mapped
+ * entries for the position's Polyglot key and walks the matching run in
+ * place, so it allocates nothing and touches only a few pages.
+ *
+ * Polyglot keys hash with the 781 fixed Random64 numbers from the Polyglot
+ * specification. They are read once from a text file (the spec's array, as
+ * hex numbers separated by whitespace or commas) with loadRandomTable()
+ * rather than compiled in; until then every probe misses. A table is only
+ * accepted if the start position hashes to START_POSITION_KEY, the value
+ * the specification gives, so a wrong or reordered table cannot silently
+ * turn every probe into a miss or a wrong move.
+ */
+class PolyglotBook {
+public:
+	static constexpr int RANDOM_COUNT = 781;
+	static constexpr uint64_t START_POSITION_KEY = 0x463B96181691FC9CULL;
+
+	PolyglotBook();
+
+	static bool loadRandomTable(const std::string& path);
+	static bool hasRandomTable();
+	static uint64_t polyglotKey(const Position& position);
+
+	bool open(const std::string& path);
+	bool isOpen() const {
+		return entryCount > 0;
+	}
+	size_t size() const {
+		return entryCount;
+	}
+
+	Move probe(const Position& position);
+	int countMoves(const Position& position) const;
+
+private:
+	struct Entry {
+		uint64_t key;
+		uint16_t move;
+		uint16_t weight;
+	};
+
+	Entry entryAt(size_t index) const;
+	size_t lowerBound(uint64_t key) const;
+	static Move decodeMove(const Position& position, uint16_t move);
+
+	MappedFile file;
+	size_t entryCount;
+	Prng rng;
+};
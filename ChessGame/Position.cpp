@@ -0,0 +1,946 @@
+#include "Position.h"
+
+#include "Evaluation.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdlib>
+#include <iostream>
+
+namespace {
+	constexpr const char* START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+	constexpr const char* PIECE_CHARS = "PNBRQKpnbrqk";
+
+	// Square indices of the pieces involved in castling
+	constexpr int E1 = 60, A1 = 56, H1 = 63;
+	constexpr int E8 = 4, A8 = 0, H8 = 7;
+
+	// Where the king and rook must stand for each castling right
+	struct CastlingHome {
+		uint8_t right;
+		int king;
+		int rook;
+		int color;
+	};
+	constexpr CastlingHome CASTLING_HOMES[] = {
+		{ WHITE_OO, E1, H1, WHITE }, { WHITE_OOO, E1, A1, WHITE },
+		{ BLACK_OO, E8, H8, BLACK }, { BLACK_OOO, E8, A8, BLACK }
+	};
+
+	// Largest clock value a FEN may give; UndoInfo keeps the halfmove clock in 16 bits
+	constexpr int MAX_CLOCK = 0xFFFF;
+
+	// What losing the king is worth in an exchange: more than any material, so no sequence ends with it
+	constexpr int KING_CAPTURE_VALUE = 20000;
+
+	/**
+	 * @brief  Castling rights that survive a move touching each square.
+	 *
+	 * A move from or to a king or rook home square clears the matching rights,
+	 * which also covers rooks being captured before they ever move.
+	 */
+	struct CastlingMasks {
+		uint8_t mask[SQUARE_NB];
+
+		CastlingMasks() {
+			for (int square = 0; square < SQUARE_NB; ++square) mask[square] = 0x0F;
+			mask[E1] &= ~(WHITE_OO | WHITE_OOO);
+			mask[H1] &= ~WHITE_OO;
+			mask[A1] &= ~WHITE_OOO;
+			mask[E8] &= ~(BLACK_OO | BLACK_OOO);
+			mask[H8] &= ~BLACK_OO;
+			mask[A8] &= ~BLACK_OOO;
+		}
+	};
+	const CastlingMasks castlingMasks;
+
+	struct ZobristKeys {
+		uint64_t piece[PIECE_NB][SQUARE_NB];
+		uint64_t castling[16];
+		uint64_t enPassantFile[BOARD_SIZE];
+		uint64_t blackToMove;
+
+		ZobristKeys() {
+			Prng prng(0x9E3779B97F4A7C15ULL);
+			for (auto& squares : piece)
+				for (uint64_t& k : squares) k = prng.next();
+			for (uint64_t& k : castling) k = prng.next();
+			for (uint64_t& k : enPassantFile) k = prng.next();
+			blackToMove = prng.next();
+		}
+	};
+	const ZobristKeys zobrist;
+
+	void initTablesOnce() {
+		static const bool initialized = (Bitboards::init(), Eval::init(), true);
+		(void)initialized;
+	}
+
+	// Splits the next space-separated field off the front of `fen`; empty once none are left
+	std::string_view nextField(std::string_view& fen) {
+		size_t start = fen.find_first_not_of(' ');
+		if (start == std::string_view::npos) {
+			fen = std::string_view();
+			return fen;
+		}
+		fen.remove_prefix(start);
+		std::string_view field = fen.substr(0, fen.find(' '));
+		fen.remove_prefix(field.size());
+		return field;
+	}
+
+	// Parses a FEN clock in [minimum, MAX_CLOCK]; an absent field keeps `value`
+	bool parseClock(std::string_view field, int minimum, int& value) {
+		if (field.empty()) return true;
+		int parsed = 0;
+		auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), parsed);
+		if (error != std::errc() || end != field.data() + field.size() || parsed < minimum || parsed > MAX_CLOCK) return false;
+		value = parsed;
+		return true;
+	}
+}
+
+/**
+ * @brief  Creates the standard starting position.
+ */
+Position::Position() {
+	initTablesOnce();
+	setFromFEN(START_FEN);
+}
+
+void Position::clear() {
+	for (Bitboard& bb : pieceBB) bb = 0;
+	colorBB[WHITE] = colorBB[BLACK] = occupiedBB = 0;
+	for (uint8_t& piece : board) piece = NO_PIECE;
+	side = WHITE;
+	castling = 0;
+	epSquare = NO_SQUARE;
+	halfmoveClock = 0;
+	fullmoveNumber = 1;
+	key = 0;
+	midgameScore = endgameScore = phase = 0;
+}
+
+void Position::putPiece(int piece, int square) {
+	Bitboard bb = squareBB(square);
+	pieceBB[piece] |= bb;
+	colorBB[colorOf(piece)] |= bb;
+	occupiedBB |= bb;
+	board[square] = static_cast<uint8_t>(piece);
+	key ^= zobrist.piece[piece][square];
+	midgameScore += Eval::midgame[piece][square];
+	endgameScore += Eval::endgame[piece][square];
+	phase += Eval::PHASE_WEIGHTS[kindOf(piece)];
+}
+
+void Position::removePiece(int square) {
+	int piece = board[square];
+	Bitboard bb = squareBB(square);
+	pieceBB[piece] ^= bb;
+	colorBB[colorOf(piece)] ^= bb;
+	occupiedBB ^= bb;
+	board[square] = NO_PIECE;
+	key ^= zobrist.piece[piece][square];
+	midgameScore -= Eval::midgame[piece][square];
+	endgameScore -= Eval::endgame[piece][square];
+	phase -= Eval::PHASE_WEIGHTS[kindOf(piece)];
+}
+
+void Position::movePieceBB(int from, int to) {
+	int piece = board[from];
+	Bitboard fromTo = squareBB(from) | squareBB(to);
+	pieceBB[piece] ^= fromTo;
+	colorBB[colorOf(piece)] ^= fromTo;
+	occupiedBB ^= fromTo;
+	board[from] = NO_PIECE;
+	board[to] = static_cast<uint8_t>(piece);
+	key ^= zobrist.piece[piece][from] ^ zobrist.piece[piece][to];
+	midgameScore += Eval::midgame[piece][to] - Eval::midgame[piece][from];
+	endgameScore += Eval::endgame[piece][to] - Eval::endgame[piece][from];
+}
+
+/**
+ * @brief  Hashes the position from scratch. The incremental key must always equal this.
+ */
+uint64_t Position::computeKey() const {
+	uint64_t result = 0;
+	for (int square = 0; square < SQUARE_NB; ++square) {
+		if (board[square] != NO_PIECE) result ^= zobrist.piece[board[square]][square];
+	}
+	result ^= zobrist.castling[castling];
+	if (epSquare != NO_SQUARE) result ^= zobrist.enPassantFile[colOf(epSquare)];
+	if (side == BLACK) result ^= zobrist.blackToMove;
+	return result;
+}
+
+void Position::verifyKey() const {
+	if (key != computeKey()) {
+		std::cerr << "Zobrist key mismatch: incremental " << std::hex << key << ", recomputed " << computeKey() << std::dec << std::endl;
+		std::abort();
+	}
+	if (evaluate() != evaluateFromScratch()) {
+		std::cerr << "Evaluation mismatch: incremental " << evaluate() << ", recomputed " << evaluateFromScratch() << std::endl;
+		std::abort();
+	}
+}
+
+/**
+ * @brief  Static evaluation in centipawns from the side to move's point of view.
+ *
+ * Material and piece-square sums are maintained by every board change, so
+ * this only blends the midgame and endgame sums by the remaining material.
+ */
+int Position::evaluate() const {
+	int score = Eval::taper(midgameScore, endgameScore, phase);
+	return side == WHITE ? score : -score;
+}
+
+/**
+ * @brief  The same evaluation summed over the board from scratch. The incremental one must always equal this.
+ */
+int Position::evaluateFromScratch() const {
+	int midgame = 0, endgame = 0, gamePhase = 0;
+	for (int square = 0; square < SQUARE_NB; ++square) {
+		int piece = board[square];
+		if (piece == NO_PIECE) continue;
+		midgame += Eval::midgame[piece][square];
+		endgame += Eval::endgame[piece][square];
+		gamePhase += Eval::PHASE_WEIGHTS[kindOf(piece)];
+	}
+	int score = Eval::taper(midgame, endgame, gamePhase);
+	return side == WHITE ? score : -score;
+}
+
+/**
+ * @brief  Loads a position from FEN. Returns false if it is not a valid position.
+ *
+ * Besides the syntax of each field this checks that every rank has eight
+ * squares, each side has one king and at most 16 pieces and 8 pawns, no pawn
+ * stands on the first or last rank, the side not to move is not in check,
+ * each castling right has its king and rook at home and an en passant square
+ * lies just behind a pawn that has double-stepped. The castling, en passant
+ * and clock fields may be left off and default to "- - 0 1". After a failure
+ * the position is unspecified.
+ */
+bool Position::setFromFEN(std::string_view fen) {
+	initTablesOnce();
+	clear();
+
+	std::string_view placement = nextField(fen);
+	std::string_view activeColor = nextField(fen);
+	std::string_view rights = nextField(fen);
+	std::string_view enPassant = nextField(fen);
+	std::string_view halfmove = nextField(fen);
+	std::string_view fullmove = nextField(fen);
+	if (!nextField(fen).empty()) return false;
+
+	int row = 0, col = 0;
+	bool afterDigit = false;
+	for (char ch : placement) {
+		if (ch == '/') {
+			if (col != BOARD_SIZE || ++row == BOARD_SIZE) return false;
+			col = 0;
+			afterDigit = false;
+		}
+		else if (ch >= '1' && ch <= '8') {
+			col += ch - '0';
+			if (afterDigit || col > BOARD_SIZE) return false;
+			afterDigit = true;
+		}
+		else {
+			const char* found = std::char_traits<char>::find(PIECE_CHARS, PIECE_NB, ch);
+			if (!found || col >= BOARD_SIZE) return false;
+			int piece = static_cast<int>(found - PIECE_CHARS);
+			if (kindOf(piece) == PAWN && (row == 0 || row == BOARD_SIZE - 1)) return false;
+			putPiece(piece, squareIndex(row, col));
+			++col;
+			afterDigit = false;
+		}
+	}
+	if (row != BOARD_SIZE - 1 || col != BOARD_SIZE) return false;
+	for (int color : { WHITE, BLACK }) {
+		if (popCount(pieces(color, KING)) != 1 || popCount(colorBB[color]) > 16 || popCount(pieces(color, PAWN)) > 8) return false;
+	}
+
+	if (activeColor == "w") side = WHITE;
+	else if (activeColor == "b") side = BLACK;
+	else return false;
+	if (isSquareAttacked(kingSquare(side ^ 1), side)) return false;
+
+	if (!rights.empty() && rights != "-") {
+		for (char ch : rights) {
+			uint8_t right = ch == 'K' ? WHITE_OO : ch == 'Q' ? WHITE_OOO : ch == 'k' ? BLACK_OO : ch == 'q' ? BLACK_OOO : 0;
+			if (!right || (castling & right)) return false;
+			castling |= right;
+		}
+		for (const CastlingHome& home : CASTLING_HOMES) {
+			if ((castling & home.right) && (board[home.king] != makePiece(home.color, KING) || board[home.rook] != makePiece(home.color, ROOK))) return false;
+		}
+	}
+
+	if (!enPassant.empty() && enPassant != "-") {
+		if (enPassant.size() != 2 || enPassant[0] < 'a' || enPassant[0] > 'h' || enPassant[1] != (side == WHITE ? '6' : '3')) return false;
+		int square = squareIndex('8' - enPassant[1], enPassant[0] - 'a');
+		int pawnSquare = side == WHITE ? square + BOARD_SIZE : square - BOARD_SIZE;  // Where the pawn landed
+		int startSquare = side == WHITE ? square - BOARD_SIZE : square + BOARD_SIZE;  // Where it came from
+		if (board[square] != NO_PIECE || board[startSquare] != NO_PIECE || board[pawnSquare] != makePiece(side ^ 1, PAWN)) return false;
+		if (Bitboards::pawnAttacks[side ^ 1][square] & pieces(side, PAWN)) epSquare = square;
+	}
+
+	if (!parseClock(halfmove, 0, halfmoveClock) || !parseClock(fullmove, 1, fullmoveNumber)) return false;
+
+	key = computeKey();
+	return true;
+}
+
+/**
+ * @brief  Writes the position as FEN into `buffer`, which must hold FEN_BUFFER_SIZE chars.
+ *
+ * The text is NUL-terminated and its length is returned. Nothing is
+ * allocated. The en passant square is only written when a capture there is
+ * possible, as that is the only time the position keeps it.
+ */
+size_t Position::writeFEN(char* buffer) const {
+	char* out = buffer;
+	for (int row = 0; row < BOARD_SIZE; ++row) {
+		int emptyCount = 0;
+		for (int col = 0; col < BOARD_SIZE; ++col) {
+			int piece = board[squareIndex(row, col)];
+			if (piece == NO_PIECE) {
+				++emptyCount;
+				continue;
+			}
+			if (emptyCount > 0) {
+				*out++ = static_cast<char>('0' + emptyCount);
+				emptyCount = 0;
+			}
+			*out++ = PIECE_CHARS[piece];
+		}
+		if (emptyCount > 0) *out++ = static_cast<char>('0' + emptyCount);
+		if (row < BOARD_SIZE - 1) *out++ = '/';
+	}
+
+	*out++ = ' ';
+	*out++ = side == WHITE ? 'w' : 'b';
+	*out++ = ' ';
+	if (!castling) *out++ = '-';
+	if (castling & WHITE_OO) *out++ = 'K';
+	if (castling & WHITE_OOO) *out++ = 'Q';
+	if (castling & BLACK_OO) *out++ = 'k';
+	if (castling & BLACK_OOO) *out++ = 'q';
+	*out++ = ' ';
+	if (epSquare == NO_SQUARE) {
+		*out++ = '-';
+	}
+	else {
+		*out++ = static_cast<char>('a' + colOf(epSquare));
+		*out++ = static_cast<char>('8' - rowOf(epSquare));
+	}
+	*out++ = ' ';
+	out = std::to_chars(out, buffer + FEN_BUFFER_SIZE, halfmoveClock).ptr;
+	*out++ = ' ';
+	out = std::to_chars(out, buffer + FEN_BUFFER_SIZE, fullmoveNumber).ptr;
+	*out = '\0';
+	return static_cast<size_t>(out - buffer);
+}
+
+/**
+ * @brief  Bitboard of all pieces of either colour attacking a square.
+ *
+ * The occupancy is passed explicitly so callers can look through pieces
+ * that are about to move.
+ */
+Bitboard Position::attackersTo(int square, Bitboard occupied) const {
+	using namespace Bitboards;
+	return (pawnAttacks[BLACK][square] & pieceBB[makePiece(WHITE, PAWN)])
+		| (pawnAttacks[WHITE][square] & pieceBB[makePiece(BLACK, PAWN)])
+		| (knightAttacks[square] & (pieceBB[makePiece(WHITE, KNIGHT)] | pieceBB[makePiece(BLACK, KNIGHT)]))
+		| (kingAttacks[square] & (pieceBB[makePiece(WHITE, KING)] | pieceBB[makePiece(BLACK, KING)]))
+		| (rookAttacks(square, occupied) & (pieceBB[makePiece(WHITE, ROOK)] | pieceBB[makePiece(BLACK, ROOK)] | pieceBB[makePiece(WHITE, QUEEN)] | pieceBB[makePiece(BLACK, QUEEN)]))
+		| (bishopAttacks(square, occupied) & (pieceBB[makePiece(WHITE, BISHOP)] | pieceBB[makePiece(BLACK, BISHOP)] | pieceBB[makePiece(WHITE, QUEEN)] | pieceBB[makePiece(BLACK, QUEEN)]));
+}
+
+bool Position::isSquareAttacked(int square, int byColor) const {
+	using namespace Bitboards;
+	Bitboard queens = pieces(byColor, QUEEN);
+	return (pawnAttacks[byColor ^ 1][square] & pieces(byColor, PAWN))
+		|| (knightAttacks[square] & pieces(byColor, KNIGHT))
+		|| (kingAttacks[square] & pieces(byColor, KING))
+		|| (rookAttacks(square, occupiedBB) & (pieces(byColor, ROOK) | queens))
+		|| (bishopAttacks(square, occupiedBB) & (pieces(byColor, BISHOP) | queens));
+}
+
+/**
+ * @brief  Enemy pieces currently giving check to the side to move.
+ */
+Bitboard Position::checkers() const {
+	return attackersTo(kingSquare(side), occupiedBB) & colorBB[side ^ 1];
+}
+
+/**
+ * @brief  Pieces of `color` that are the only blocker between their king and an enemy slider.
+ */
+Bitboard Position::pinnedPieces(int color) const {
+	using namespace Bitboards;
+	int king = kingSquare(color);
+	int them = color ^ 1;
+	Bitboard queens = pieces(them, QUEEN);
+	Bitboard snipers = (rookAttacks(king, 0) & (pieces(them, ROOK) | queens))
+		| (bishopAttacks(king, 0) & (pieces(them, BISHOP) | queens));
+
+	Bitboard pinned = 0;
+	while (snipers) {
+		Bitboard blockers = between[king][popLsb(snipers)] & occupiedBB;
+		if (blockers && !moreThanOne(blockers)) pinned |= blockers & colorBB[color];
+	}
+	return pinned;
+}
+
+/**
+ * @brief  Material the side making `move` comes out ahead after the best exchange sequence on its target square.
+ *
+ * Both sides recapture with their least valuable attacker and may stop
+ * whenever continuing would lose material. Sliders behind a capturing piece
+ * join in as it leaves (x-rays), and a king only recaptures if nothing
+ * defends the square. Pins and checks are ignored, so this is an estimate,
+ * but it needs no move generation and no make/unmake. The mover is the
+ * piece on `from`, which need not belong to the side to move.
+ */
+int Position::see(Move move) const {
+	using namespace Bitboards;
+	if (move.flag() == MoveFlag::CASTLING) return 0;
+
+	int from = move.from(), to = move.to();
+	int side = colorOf(board[from]);
+	int nextVictim = kindOf(board[from]);
+	Bitboard occupied = occupiedBB ^ squareBB(from);
+
+	int gain[32];
+	gain[0] = board[to] != NO_PIECE ? Eval::PIECE_VALUES[kindOf(board[to])] : 0;
+	if (move.flag() == MoveFlag::EN_PASSANT) {
+		gain[0] = Eval::PIECE_VALUES[PAWN];
+		occupied ^= squareBB(squareIndex(rowOf(from), colOf(to)));
+	}
+	else if (move.flag() == MoveFlag::PROMOTION) {
+		gain[0] += Eval::PIECE_VALUES[move.promotion()] - Eval::PIECE_VALUES[PAWN];
+		nextVictim = move.promotion();
+	}
+
+	Bitboard diagonal = pieceBB[makePiece(WHITE, BISHOP)] | pieceBB[makePiece(BLACK, BISHOP)] | pieceBB[makePiece(WHITE, QUEEN)] | pieceBB[makePiece(BLACK, QUEEN)];
+	Bitboard straight = pieceBB[makePiece(WHITE, ROOK)] | pieceBB[makePiece(BLACK, ROOK)] | pieceBB[makePiece(WHITE, QUEEN)] | pieceBB[makePiece(BLACK, QUEEN)];
+	Bitboard attackers = attackersTo(to, occupied) & occupied;
+
+	int depth = 0;
+	while (true) {
+		side ^= 1;
+		Bitboard ours = attackers & colorBB[side];
+		if (!ours) break;
+
+		int kind = PAWN;
+		while (!(ours & pieceBB[makePiece(side, kind)])) ++kind;
+		// The king cannot capture into a defended square
+		if (kind == KING && (attackers & colorBB[side ^ 1])) break;
+
+		++depth;
+		gain[depth] = (nextVictim == KING ? KING_CAPTURE_VALUE : Eval::PIECE_VALUES[nextVictim]) - gain[depth - 1];
+		nextVictim = kind;
+
+		occupied ^= squareBB(lsb(ours & pieceBB[makePiece(side, kind)]));
+		if (kind == PAWN || kind == BISHOP || kind == QUEEN) attackers |= bishopAttacks(to, occupied) & diagonal;
+		if (kind == ROOK || kind == QUEEN) attackers |= rookAttacks(to, occupied) & straight;
+		attackers &= occupied;
+	}
+
+	// Each side either stops or takes the recapture, whichever leaves it better off
+	while (depth > 0) {
+		gain[depth - 1] = -std::max(-gain[depth - 1], gain[depth]);
+		--depth;
+	}
+	return gain[0];
+}
+
+/**
+ * @brief  Pieces of `color`, other than the king, that the opponent wins material by capturing.
+ */
+Bitboard Position::hangingPieces(int color) const {
+	Bitboard hanging = 0;
+	Bitboard targets = colorBB[color] & ~pieceBB[makePiece(color, KING)];
+	while (targets) {
+		int square = popLsb(targets);
+		Bitboard attackers = attackersTo(square, occupiedBB) & colorBB[color ^ 1];
+		while (attackers) {
+			if (see(Move(popLsb(attackers), square)) > 0) {
+				hanging |= squareBB(square);
+				break;
+			}
+		}
+	}
+	return hanging;
+}
+
+/**
+ * @brief  Writes the legal moves of `type` for the side to move into `moves` and returns the count.
+ *
+ * `moves` must have room for MAX_MOVES entries. Checkers and pinned pieces are
+ * computed once, then every non-king move is restricted to the check-evasion
+ * mask and, for pinned pieces, to the line through the king. Only king steps
+ * and en passant need an attack test on the resulting occupancy. Tactical
+ * and quiet moves together are exactly the moves of MoveGenType::ALL.
+ */
+int Position::generateLegalMoves(Move* moves, MoveGenType type) const {
+	using namespace Bitboards;
+	int count = 0;
+	int us = side, them = side ^ 1;
+	int king = kingSquare(us);
+	Bitboard ours = colorBB[us], theirs = colorBB[them];
+	Bitboard empty = ~occupiedBB;
+	Bitboard checkerSet = checkers();
+	Bitboard pinned = pinnedPieces(us);
+	Bitboard theirQueens = pieces(them, QUEEN);
+	Bitboard theirRookLike = pieces(them, ROOK) | theirQueens;
+	Bitboard theirBishopLike = pieces(them, BISHOP) | theirQueens;
+
+	// Squares pieces other than pawns may move to
+	Bitboard targetMask = type == MoveGenType::TACTICAL ? theirs : type == MoveGenType::QUIET ? empty : ~ours;
+	Bitboard promotionRows = rowBB(0) | rowBB(BOARD_SIZE - 1);
+
+	auto add = [&](int from, int to, MoveFlag flag = MoveFlag::NORMAL, int promotion = KNIGHT) {
+		moves[count++] = Move(from, to, flag, promotion);
+	};
+
+	// King steps: the king itself is lifted from the occupancy so it cannot hide behind its own square
+	Bitboard withoutKing = occupiedBB ^ squareBB(king);
+	Bitboard kingTargets = kingAttacks[king] & targetMask;
+	while (kingTargets) {
+		int to = popLsb(kingTargets);
+		if (!(attackersTo(to, withoutKing) & theirs)) add(king, to);
+	}
+
+	// In double check only the king can move
+	if (moreThanOne(checkerSet)) return count;
+
+	// Squares that capture the checker or block its ray; everywhere when not in check
+	Bitboard evasionMask = checkerSet ? between[king][lsb(checkerSet)] | checkerSet : ~0ULL;
+
+	auto pinMask = [&](int from) {
+		return (pinned & squareBB(from)) ? line[king][from] : ~0ULL;
+	};
+
+	// Pawns: white moves up the board (towards row 0), black moves down
+	int forward = us == WHITE ? -8 : 8;
+	int startRow = us == WHITE ? 6 : 1;
+	Bitboard pawns = pieces(us, PAWN);
+	while (pawns) {
+		int from = popLsb(pawns);
+		Bitboard targets = 0;
+		int oneStep = from + forward;
+		if (empty & squareBB(oneStep)) {
+			targets |= squareBB(oneStep);
+			int twoSteps = oneStep + forward;
+			if (rowOf(from) == startRow && (empty & squareBB(twoSteps))) targets |= squareBB(twoSteps);
+		}
+		targets |= pawnAttacks[us][from] & theirs;
+		targets &= evasionMask & pinMask(from);
+		if (type == MoveGenType::TACTICAL) targets &= theirs | promotionRows;
+		else if (type == MoveGenType::QUIET) targets &= empty & ~promotionRows;
+
+		while (targets) {
+			int to = popLsb(targets);
+			if (rowOf(to) == 0 || rowOf(to) == BOARD_SIZE - 1) {
+				for (int kind : { QUEEN, ROOK, BISHOP, KNIGHT }) add(from, to, MoveFlag::PROMOTION, kind);
+			}
+			else {
+				add(from, to);
+			}
+		}
+
+		// En passant removes two pieces from one row, which no pin mask describes; test the result
+		if (type != MoveGenType::QUIET && epSquare != NO_SQUARE && (pawnAttacks[us][from] & squareBB(epSquare))) {
+			int captured = squareIndex(rowOf(from), colOf(epSquare));
+			Bitboard after = (occupiedBB ^ squareBB(from) ^ squareBB(captured)) | squareBB(epSquare);
+			bool exposed = (rookAttacks(king, after) & theirRookLike) || (bishopAttacks(king, after) & theirBishopLike)
+				|| (checkerSet & ~squareBB(captured) & (pieces(them, PAWN) | pieces(them, KNIGHT)));
+			if (!exposed) add(from, epSquare, MoveFlag::EN_PASSANT);
+		}
+	}
+
+	for (int kind : { KNIGHT, BISHOP, ROOK, QUEEN }) {
+		Bitboard pieceSet = pieces(us, kind);
+		while (pieceSet) {
+			int from = popLsb(pieceSet);
+			Bitboard targets;
+			switch (kind) {
+			case KNIGHT: targets = knightAttacks[from]; break;
+			case BISHOP: targets = bishopAttacks(from, occupiedBB); break;
+			case ROOK:   targets = rookAttacks(from, occupiedBB); break;
+			default:     targets = queenAttacks(from, occupiedBB); break;
+			}
+			targets &= targetMask & evasionMask & pinMask(from);
+			while (targets) add(from, popLsb(targets));
+		}
+	}
+
+	// Castling: the rook must still be home, every square between it and the king
+	// empty, and the king may not start in, pass through or land on an attacked square
+	uint8_t kingSide = us == WHITE ? WHITE_OO : BLACK_OO;
+	uint8_t queenSide = us == WHITE ? WHITE_OOO : BLACK_OOO;
+	int kingHome = us == WHITE ? E1 : E8;
+	int rook = makePiece(us, ROOK);
+	if (type != MoveGenType::TACTICAL && !checkerSet && (castling & (kingSide | queenSide)) && king == kingHome) {
+		int kingSideRook = us == WHITE ? H1 : H8;
+		int queenSideRook = us == WHITE ? A1 : A8;
+		if ((castling & kingSide) && board[kingSideRook] == rook
+			&& !(between[king][kingSideRook] & occupiedBB)
+			&& !isSquareAttacked(king + 1, them) && !isSquareAttacked(king + 2, them)) {
+			add(king, king + 2, MoveFlag::CASTLING);
+		}
+		if ((castling & queenSide) && board[queenSideRook] == rook
+			&& !(between[king][queenSideRook] & occupiedBB)
+			&& !isSquareAttacked(king - 1, them) && !isSquareAttacked(king - 2, them)) {
+			add(king, king - 2, MoveFlag::CASTLING);
+		}
+	}
+
+	return count;
+}
+
+/**
+ * @brief  Plays a move produced by the generator and records what it destroyed in `undo`.
+ *
+ * The move is not validated. Passing the same move and record to unmakeMove
+ * restores the position exactly.
+ */
+void Position::makeMove(Move move, UndoInfo& undo) {
+	int from = move.from(), to = move.to();
+	int piece = board[from];
+	bool isPawn = kindOf(piece) == PAWN;
+
+	undo.key = key;
+	undo.castling = castling;
+	undo.epSquare = static_cast<int8_t>(epSquare);
+	undo.halfmoveClock = static_cast<uint16_t>(halfmoveClock);
+
+	// The en passant victim sits beside the moving pawn, not on the target square
+	int captureSquare = move.flag() == MoveFlag::EN_PASSANT ? squareIndex(rowOf(from), colOf(to)) : to;
+	undo.captured = board[captureSquare];
+	if (undo.captured != NO_PIECE) removePiece(captureSquare);
+
+	movePieceBB(from, to);
+
+	if (move.flag() == MoveFlag::PROMOTION) {
+		removePiece(to);
+		putPiece(makePiece(side, move.promotion()), to);
+	}
+	else if (move.flag() == MoveFlag::CASTLING) {
+		bool kingSide = to > from;
+		int rowStart = squareIndex(rowOf(from), 0);
+		movePieceBB(rowStart + (kingSide ? 7 : 0), rowStart + (kingSide ? 5 : 3));
+	}
+
+	key ^= zobrist.castling[castling];
+	castling &= castlingMasks.mask[from] & castlingMasks.mask[to];
+	key ^= zobrist.castling[castling];
+
+	// Only applies to a double move from the starting position, and only if an enemy pawn can take
+	if (epSquare != NO_SQUARE) key ^= zobrist.enPassantFile[colOf(epSquare)];
+	epSquare = NO_SQUARE;
+	if (isPawn && (to - from == 16 || from - to == 16)) {
+		int skipped = (from + to) / 2;
+		if (Bitboards::pawnAttacks[side][skipped] & pieces(side ^ 1, PAWN)) {
+			epSquare = skipped;
+			key ^= zobrist.enPassantFile[colOf(skipped)];
+		}
+	}
+
+	halfmoveClock = (isPawn || undo.captured != NO_PIECE) ? 0 : halfmoveClock + 1;
+	if (side == BLACK) ++fullmoveNumber;
+	side ^= 1;
+	key ^= zobrist.blackToMove;
+
+#ifdef HASH_DEBUG
+	verifyKey();
+#endif
+}
+
+/**
+ * @brief  Takes back a move played with makeMove, in reverse order of the steps there.
+ */
+void Position::unmakeMove(Move move, const UndoInfo& undo) {
+	int from = move.from(), to = move.to();
+
+	side ^= 1;
+	if (side == BLACK) --fullmoveNumber;
+
+	if (move.flag() == MoveFlag::PROMOTION) {
+		removePiece(to);
+		putPiece(makePiece(side, PAWN), to);
+	}
+	else if (move.flag() == MoveFlag::CASTLING) {
+		bool kingSide = to > from;
+		int rowStart = squareIndex(rowOf(from), 0);
+		movePieceBB(rowStart + (kingSide ? 5 : 3), rowStart + (kingSide ? 7 : 0));
+	}
+
+	movePieceBB(to, from);
+
+	if (undo.captured != NO_PIECE) {
+		int captureSquare = move.flag() == MoveFlag::EN_PASSANT ? squareIndex(rowOf(from), colOf(to)) : to;
+		putPiece(undo.captured, captureSquare);
+	}
+
+	castling = undo.castling;
+	epSquare = undo.epSquare;
+	halfmoveClock = undo.halfmoveClock;
+	key = undo.key;
+
+#ifdef HASH_DEBUG
+	verifyKey();
+#endif
+}
+
+/**
+ * @brief  Passes the turn without moving, for null-move pruning in search.
+ *
+ * Must not be called while in check.
+ */
+void Position::makeNullMove(UndoInfo& undo) {
+	undo.key = key;
+	undo.captured = NO_PIECE;
+	undo.castling = castling;
+	undo.epSquare = static_cast<int8_t>(epSquare);
+	undo.halfmoveClock = static_cast<uint16_t>(halfmoveClock);
+
+	if (epSquare != NO_SQUARE) key ^= zobrist.enPassantFile[colOf(epSquare)];
+	epSquare = NO_SQUARE;
+	++halfmoveClock;
+	side ^= 1;
+	key ^= zobrist.blackToMove;
+}
+
+void Position::unmakeNullMove(const UndoInfo& undo) {
+	side ^= 1;
+	epSquare = undo.epSquare;
+	halfmoveClock = undo.halfmoveClock;
+	key = undo.key;
+}
+
+/**
+ * @brief  True if the side to move has at least one legal move.
+ *
+ * Follows generateLegalMoves but stops at the first move found, so in most
+ * positions only the king steps or a single piece are looked at. Castling is
+ * never needed: it is only legal when the king could also step onto the
+ * square next to it.
+ */
+bool Position::hasLegalMove() const {
+	using namespace Bitboards;
+	int us = side, them = side ^ 1;
+	int king = kingSquare(us);
+	Bitboard ours = colorBB[us], theirs = colorBB[them];
+
+	Bitboard withoutKing = occupiedBB ^ squareBB(king);
+	Bitboard kingTargets = kingAttacks[king] & ~ours;
+	while (kingTargets) {
+		if (!(attackersTo(popLsb(kingTargets), withoutKing) & theirs)) return true;
+	}
+
+	Bitboard checkerSet = checkers();
+	if (moreThanOne(checkerSet)) return false;
+
+	Bitboard evasionMask = checkerSet ? between[king][lsb(checkerSet)] | checkerSet : ~0ULL;
+	Bitboard pinned = pinnedPieces(us);
+	auto pinMask = [&](int from) {
+		return (pinned & squareBB(from)) ? line[king][from] : ~0ULL;
+	};
+
+	for (int kind : { KNIGHT, BISHOP, ROOK, QUEEN }) {
+		Bitboard pieceSet = pieces(us, kind);
+		while (pieceSet) {
+			int from = popLsb(pieceSet);
+			Bitboard targets;
+			switch (kind) {
+			case KNIGHT: targets = knightAttacks[from]; break;
+			case BISHOP: targets = bishopAttacks(from, occupiedBB); break;
+			case ROOK:   targets = rookAttacks(from, occupiedBB); break;
+			default:     targets = queenAttacks(from, occupiedBB); break;
+			}
+			if (targets & ~ours & evasionMask & pinMask(from)) return true;
+		}
+	}
+
+	int forward = us == WHITE ? -8 : 8;
+	int startRow = us == WHITE ? 6 : 1;
+	Bitboard empty = ~occupiedBB;
+	Bitboard pawns = pieces(us, PAWN);
+	while (pawns) {
+		int from = popLsb(pawns);
+		Bitboard targets = pawnAttacks[us][from] & theirs;
+		int oneStep = from + forward;
+		if (empty & squareBB(oneStep)) {
+			targets |= squareBB(oneStep);
+			int twoSteps = oneStep + forward;
+			if (rowOf(from) == startRow && (empty & squareBB(twoSteps))) targets |= squareBB(twoSteps);
+		}
+		if (targets & evasionMask & pinMask(from)) return true;
+
+		if (epSquare != NO_SQUARE && (pawnAttacks[us][from] & squareBB(epSquare))) {
+			int captured = squareIndex(rowOf(from), colOf(epSquare));
+			Bitboard after = (occupiedBB ^ squareBB(from) ^ squareBB(captured)) | squareBB(epSquare);
+			Bitboard theirQueens = pieces(them, QUEEN);
+			bool exposed = (rookAttacks(king, after) & (pieces(them, ROOK) | theirQueens)) || (bishopAttacks(king, after) & (pieces(them, BISHOP) | theirQueens))
+				|| (checkerSet & ~squareBB(captured) & (pieces(them, PAWN) | pieces(them, KNIGHT)));
+			if (!exposed) return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * @brief  Whether `move` is legal for the side to move, for any 16-bit value.
+ *
+ * Lets the search try a move from the transposition table or a killer
+ * slot without generating the whole move list first. Ordinary moves are
+ * checked against the piece's attacks and the same check-evasion and pin
+ * masks the generator uses; castling and en passant are rare enough to
+ * look up in the generated list.
+ */
+bool Position::isLegal(Move move) const {
+	using namespace Bitboards;
+	int from = move.from(), to = move.to();
+	int piece = board[from];
+	if (move == NO_MOVE || piece == NO_PIECE || colorOf(piece) != side) return false;
+	if (board[to] != NO_PIECE && colorOf(board[to]) == side) return false;
+
+	if (move.flag() == MoveFlag::CASTLING || move.flag() == MoveFlag::EN_PASSANT) {
+		Move moves[MAX_MOVES];
+		int count = generateLegalMoves(moves, move.flag() == MoveFlag::CASTLING ? MoveGenType::QUIET : MoveGenType::TACTICAL);
+		return std::find(moves, moves + count, move) != moves + count;
+	}
+
+	int us = side;
+	int kind = kindOf(piece);
+	bool promotes = kind == PAWN && (rowOf(to) == 0 || rowOf(to) == BOARD_SIZE - 1);
+	if (promotes != (move.flag() == MoveFlag::PROMOTION)) return false;
+	if (!promotes && move.promotion() != KNIGHT) return false;  // Only promotions use those bits
+
+	Bitboard targets;
+	switch (kind) {
+	case PAWN: {
+		int forward = us == WHITE ? -8 : 8;
+		int startRow = us == WHITE ? 6 : 1;
+		targets = pawnAttacks[us][from] & colorBB[us ^ 1];
+		if (board[from + forward] == NO_PIECE) {
+			targets |= squareBB(from + forward);
+			if (rowOf(from) == startRow && board[from + 2 * forward] == NO_PIECE) targets |= squareBB(from + 2 * forward);
+		}
+		break;
+	}
+	case KNIGHT: targets = knightAttacks[from]; break;
+	case BISHOP: targets = bishopAttacks(from, occupiedBB); break;
+	case ROOK:   targets = rookAttacks(from, occupiedBB); break;
+	case QUEEN:  targets = queenAttacks(from, occupiedBB); break;
+	default:
+		return (kingAttacks[from] & squareBB(to)) && !(attackersTo(to, occupiedBB ^ squareBB(from)) & colorBB[us ^ 1]);
+	}
+	if (!(targets & squareBB(to))) return false;
+
+	int king = kingSquare(us);
+	Bitboard checkerSet = checkers();
+	if (moreThanOne(checkerSet)) return false;
+	if (checkerSet && !((between[king][lsb(checkerSet)] | checkerSet) & squareBB(to))) return false;
+	return !(pinnedPieces(us) & squareBB(from)) || (line[king][from] & squareBB(to));
+}
+
+/**
+ * @brief  True if neither side can ever checkmate: bare kings, a single minor
+ *         piece, or only bishops that all stand on squares of one colour.
+ */
+bool Position::hasInsufficientMaterial() const {
+	Bitboard heavy = pieces(WHITE, PAWN) | pieces(BLACK, PAWN) | pieces(WHITE, ROOK) | pieces(BLACK, ROOK)
+		| pieces(WHITE, QUEEN) | pieces(BLACK, QUEEN);
+	if (heavy) return false;
+
+	Bitboard knights = pieces(WHITE, KNIGHT) | pieces(BLACK, KNIGHT);
+	Bitboard bishops = pieces(WHITE, BISHOP) | pieces(BLACK, BISHOP);
+	if (popCount(knights | bishops) <= 1) return true;
+	return !knights && (!(bishops & LIGHT_SQUARES_BB) || !(bishops & ~LIGHT_SQUARES_BB));
+}
+
+/**
+ * @brief  Whether the game has ended in this position, and how.
+ *
+ * `history` holds the keys of the positions that led here, oldest first and
+ * without the current one; only the last getHalfmoveClock() of them can
+ * repeat it. Mate and stalemate are checked first since they stand even on
+ * the move that reaches a draw by rule. Allocates nothing.
+ */
+GameStatus Position::gameStatus(const uint64_t* history, int historySize) const {
+	if (!hasLegalMove()) return inCheck() ? GameStatus::CHECKMATE : GameStatus::STALEMATE;
+	if (halfmoveClock >= 100) return GameStatus::FIFTY_MOVE_RULE;
+
+	int reversible = std::min(historySize, halfmoveClock);
+	int repetitions = 0;
+	for (int distance = 4; distance <= reversible; distance += 2) {
+		if (history[historySize - distance] == key && ++repetitions == 2) return GameStatus::THREEFOLD_REPETITION;
+	}
+
+	if (hasInsufficientMaterial()) return GameStatus::INSUFFICIENT_MATERIAL;
+	return GameStatus::ONGOING;
+}
+
+/**
+ * @brief  Finds the legal move between two squares, or NO_MOVE if there is none.
+ *
+ * Promotions default to a queen unless another PieceKind is requested.
+ */
+Move Position::findMove(int from, int to, int promotion) const {
+	Move moves[MAX_MOVES];
+	int count = generateLegalMoves(moves);
+	for (int i = 0; i < count; ++i) {
+		if (moves[i].from() == from && moves[i].to() == to
+			&& (moves[i].flag() != MoveFlag::PROMOTION || moves[i].promotion() == promotion)) {
+			return moves[i];
+		}
+	}
+	return NO_MOVE;
+}
+
+/**
+ * @brief  Finds the legal move written in UCI notation ("e2e4", "e7e8q"), or NO_MOVE.
+ */
+Move Position::findUciMove(const std::string& uci) const {
+	if (uci.size() < 4 || uci[0] < 'a' || uci[0] > 'h' || uci[1] < '1' || uci[1] > '8'
+		|| uci[2] < 'a' || uci[2] > 'h' || uci[3] < '1' || uci[3] > '8') return NO_MOVE;
+
+	int from = squareIndex('8' - uci[1], uci[0] - 'a');
+	int to = squareIndex('8' - uci[3], uci[2] - 'a');
+	int promotion = QUEEN;
+	if (uci.size() > 4) {
+		switch (uci[4]) {
+		case 'n': promotion = KNIGHT; break;
+		case 'b': promotion = BISHOP; break;
+		case 'r': promotion = ROOK; break;
+		default: break;
+		}
+	}
+	return findMove(from, to, promotion);
+}
+
+std::string Position::moveToUci(Move move) {
+	std::string uci;
+	uci += static_cast<char>('a' + colOf(move.from()));
+	uci += static_cast<char>('8' - rowOf(move.from()));
+	uci += static_cast<char>('a' + colOf(move.to()));
+	uci += static_cast<char>('8' - rowOf(move.to()));
+	if (move.flag() == MoveFlag::PROMOTION) uci += "pnbrqk"[move.promotion()];
+	return uci;
+}
+
+PieceType Position::toPieceType(int piece) {
+	return piece == NO_PIECE ? PieceType::NONE : static_cast<PieceType>(PIECE_CHARS[piece]);
+}
+
+int Position::fromPieceType(PieceType type) {
+	const char* found = std::char_traits<char>::find(PIECE_CHARS, PIECE_NB, static_cast<char>(type));
+	return found ? static_cast<int>(found - PIECE_CHARS) : NO_PIECE;
+}
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "Bitboard.h"
+#include "Constants.h"
+#include "Types.h"
+
+// Colourless piece kinds, used together with a colour to index piece bitboards
+enum PieceKind {
+	PAWN,
+	KNIGHT,
+	BISHOP,
+	ROOK,
+	QUEEN,
+	KING,
+	PIECE_KIND_NB
+};
+
+// Piece codes are colour * PIECE_KIND_NB + kind, so white pieces are 0..5 and black pieces 6..11
+constexpr int PIECE_NB = 12;
+constexpr int NO_PIECE = 12;
+constexpr int WHITE = static_cast<int>(Color::WHITE);
+constexpr int BLACK = static_cast<int>(Color::BLACK);
+
+constexpr int makePiece(int color, int kind) {
+	return color * PIECE_KIND_NB + kind;
+}
+
+constexpr int kindOf(int piece) {
+	return piece % PIECE_KIND_NB;
+}
+
+constexpr int colorOf(int piece) {
+	return piece / PIECE_KIND_NB;
+}
+
+enum CastlingRight : uint8_t {
+	WHITE_OO = 1,
+	WHITE_OOO = 2,
+	BLACK_OO = 4,
+	BLACK_OOO = 8
+};
+
+enum class MoveFlag : uint8_t {
+	NORMAL,
+	PROMOTION,
+	EN_PASSANT,
+	CASTLING
+};
+
+// Which legal moves to generate. Tactical moves are captures, en passant and
+// every promotion; quiet moves are all the others, castling included.
+enum class MoveGenType : uint8_t {
+	ALL,
+	TACTICAL,
+	QUIET
+};
+
+/**
+ * @brief  A move packed into 16 bits: from in bits 0-5, to in 6-11, the
+ *         promotion piece (knight to queen) in 12-13 and the MoveFlag in 14-15.
+ *
+ * Castling is stored as the king's two-square step. The all-zero value
+ * (a8a8) is never a legal move and serves as NO_MOVE. The default
+ * constructor leaves the move uninitialised so move arrays cost nothing.
+ */
+class Move {
+public:
+	Move() = default;
+	constexpr Move(int from, int to, MoveFlag flag = MoveFlag::NORMAL, int promotion = KNIGHT)
+		: data(static_cast<uint16_t>(from | (to << 6) | ((promotion - KNIGHT) << 12) | (static_cast<int>(flag) << 14))) {
+	}
+
+	static constexpr Move fromRaw(uint16_t raw) {
+		Move move(0, 0);
+		move.data = raw;
+		return move;
+	}
+
+	constexpr int from() const {
+		return data & 0x3F;
+	}
+	constexpr int to() const {
+		return (data >> 6) & 0x3F;
+	}
+	constexpr MoveFlag flag() const {
+		return static_cast<MoveFlag>(data >> 14);
+	}
+	// PieceKind, only meaningful for MoveFlag::PROMOTION
+	constexpr int promotion() const {
+		return KNIGHT + ((data >> 12) & 3);
+	}
+	constexpr uint16_t raw() const {
+		return data;
+	}
+
+	constexpr bool operator==(const Move& other) const {
+		return data == other.data;
+	}
+	constexpr bool operator!=(const Move& other) const {
+		return data != other.data;
+	}
+
+private:
+	uint16_t data;
+};
+
+static_assert(sizeof(Move) == 2, "Move must stay 16 bits");
+
+constexpr Move NO_MOVE = Move(0, 0);
+
+// No legal chess position has more than 218 moves
+constexpr int MAX_MOVES = 256;
+
+/**
+ * @brief  Fixed-capacity move list that lives on the stack.
+ */
+struct MoveList {
+	Move moves[MAX_MOVES];
+	int count = 0;
+
+	void push_back(Move move) {
+		moves[count++] = move;
+	}
+	int size() const {
+		return count;
+	}
+	bool empty() const {
+		return count == 0;
+	}
+	Move operator[](int index) const {
+		return moves[index];
+	}
+	bool contains(Move move) const {
+		for (int i = 0; i < count; ++i) {
+			if (moves[i] == move) return true;
+		}
+		return false;
+	}
+
+	Move* begin() {
+		return moves;
+	}
+	Move* end() {
+		return moves + count;
+	}
+	const Move* begin() const {
+		return moves;
+	}
+	const Move* end() const {
+		return moves + count;
+	}
+};
+
+enum class GameStatus : uint8_t {
+	ONGOING,
+	CHECKMATE,
+	STALEMATE,
+	THREEFOLD_REPETITION,
+	FIFTY_MOVE_RULE,
+	INSUFFICIENT_MATERIAL,
+	TIME_FORFEIT  // Set by a game clock; Position::gameStatus never returns it
+};
+
+// Room for the longest FEN writeFEN produces, terminating NUL included
+constexpr size_t FEN_BUFFER_SIZE = 128;
+
+/**
+ * @brief  State that a move destroys and unmakeMove needs back.
+ *
+ * Everything else (piece placement, side to move, move number) is
+ * recomputed from the move itself.
+ */
+struct UndoInfo {
+	uint64_t key;
+	uint8_t captured;      // Piece code or NO_PIECE
+	uint8_t castling;
+	int8_t epSquare;
+	uint16_t halfmoveClock;
+};
+
+/**
+ * @brief  Headless bitboard representation of a chess position.
+ *
+ * Holds one bitboard per piece plus colour occupancy and a square-indexed
+ * mailbox for O(1) piece lookup. It has no SFML or Windows dependencies and
+ * is plain data, so it can be freely copied.
+ *
+ * A 64-bit Zobrist key is updated incrementally by every board change. The
+ * en passant file only enters the key when an enemy pawn could capture there,
+ * which is also the only time epSquare is set. The material and
+ * piece-square sums behind evaluate() are kept up to date the same way.
+ * Define HASH_DEBUG to check the key and the sums against a full
+ * recomputation after every make and unmake.
+ */
+class Position {
+public:
+	Position();
+
+	bool setFromFEN(std::string_view fen);
+	size_t writeFEN(char* buffer) const;
+
+	int generateLegalMoves(Move* moves, MoveGenType type = MoveGenType::ALL) const;
+	void generateLegalMoves(MoveList& list, MoveGenType type = MoveGenType::ALL) const {
+		list.count = generateLegalMoves(list.moves, type);
+	}
+	bool hasLegalMove() const;
+	bool isLegal(Move move) const;
+	bool isTactical(Move move) const {
+		return move.flag() == MoveFlag::PROMOTION || move.flag() == MoveFlag::EN_PASSANT || board[move.to()] != NO_PIECE;
+	}
+	void makeMove(Move move, UndoInfo& undo);
+	void unmakeMove(Move move, const UndoInfo& undo);
+	void makeNullMove(UndoInfo& undo);
+	void unmakeNullMove(const UndoInfo& undo);
+
+	bool isSquareAttacked(int square, int byColor) const;
+	Bitboard attackersTo(int square, Bitboard occupied) const;
+	Bitboard checkers() const;
+	Bitboard pinnedPieces(int color) const;
+	bool inCheck() const {
+		return isSquareAttacked(kingSquare(side), side ^ 1);
+	}
+	int see(Move move) const;
+	Bitboard hangingPieces(int color) const;
+	bool hasInsufficientMaterial() const;
+	GameStatus gameStatus(const uint64_t* history, int historySize) const;
+
+	uint64_t getKey() const {
+		return key;
+	}
+	uint64_t computeKey() const;
+
+	int evaluate() const;
+	int evaluateFromScratch() const;
+
+	Move findMove(int from, int to, int promotion = QUEEN) const;
+	Move findUciMove(const std::string& uci) const;
+	static std::string moveToUci(Move move);
+
+	int pieceOn(int square) const {
+		return board[square];
+	}
+	Bitboard pieces(int color, int kind) const {
+		return pieceBB[makePiece(color, kind)];
+	}
+	Bitboard piecesOf(int color) const {
+		return colorBB[color];
+	}
+	Bitboard occupied() const {
+		return occupiedBB;
+	}
+	int kingSquare(int color) const {
+		return lsb(pieceBB[makePiece(color, KING)]);
+	}
+	Color sideToMove() const {
+		return static_cast<Color>(side);
+	}
+	uint8_t getCastlingRights() const {
+		return castling;
+	}
+	int getEnPassantSquare() const {
+		return epSquare;
+	}
+	int getHalfmoveClock() const {
+		return halfmoveClock;
+	}
+	int getFullmoveNumber() const {
+		return fullmoveNumber;
+	}
+
+	static PieceType toPieceType(int piece);
+	static int fromPieceType(PieceType type);
+
+private:
+	void clear();
+	void putPiece(int piece, int square);
+	void removePiece(int square);
+	void movePieceBB(int from, int to);
+	void verifyKey() const;
+
+	Bitboard pieceBB[PIECE_NB];
+	Bitboard colorBB[2];
+	Bitboard occupiedBB;
+	uint8_t board[SQUARE_NB];
+	uint64_t key;
+
+	// Eval::midgame and Eval::endgame summed over all pieces, and the game phase they share
+	int midgameScore;
+	int endgameScore;
+	int phase;
+
+	int side;
+	uint8_t castling;
+	int epSquare;
+	int halfmoveClock;
+	int fullmoveNumber;
+};
@@ -0,0 +1,113 @@
+#include "Search.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace {
+	// Kept back from the clock for sending the move and for scheduling delays on a busy machine
+	constexpr int64_t MOVE_OVERHEAD_MS = 50;
+
+	// Moves the clock is expected to last for when the time control does not say
+	constexpr int DEFAULT_MOVES_TO_GO = 30;
+}
+
+Search::Search() {
+	setThreads(1);
+}
+
+/**
+ * @brief  Sets the number of search threads, clamped to at least one.
+ *
+ * Not safe while a search is running.
+ */
+void Search::setThreads(int count) {
+	count = std::max(count, 1);
+	workers.clear();
+	for (int id = 0; id < count; ++id) workers.push_back(std::make_unique<SearchWorker>(id, tt, shared));
+}
+
+/**
+ * @brief  Searches `rootPosition` with every worker until the limits are hit.
+ *
+ * Helpers run on their own threads while the main worker runs on the calling
+ * one; once it returns the helpers are stopped and joined. The reported lines
+ * come from the main worker and the counters are summed over all of them.
+ */
+SearchResult Search::think(const Position& rootPosition, int multiPV) {
+	shared.limits = limits;
+	shared.time = limits.timeBudget(static_cast<int>(rootPosition.sideToMove()));
+	shared.startTime = std::chrono::steady_clock::now();
+	shared.stop = false;
+	shared.nodes = 0;
+	tt.newSearch();
+
+	std::vector<std::thread> helpers;
+	for (size_t i = 1; i < workers.size(); ++i) {
+		helpers.emplace_back(&SearchWorker::run, workers[i].get(), std::cref(rootPosition), multiPV);
+	}
+	workers[0]->run(rootPosition, multiPV);
+	shared.stop = true;
+	for (std::thread& helper : helpers) helper.join();
+
+	SearchResult result = workers[0]->getResult();
+	result.nodes = 0;
+	result.ttStats = TTStats();
+	result.betaCutoffs = 0;
+	result.firstMoveCutoffs = 0;
+	for (const auto& worker : workers) {
+		const SearchResult& workerResult = worker->getResult();
+		result.threadNodes.push_back(workerResult.nodes);
+		result.nodes += workerResult.nodes;
+		result.ttStats += workerResult.ttStats;
+		result.betaCutoffs += workerResult.betaCutoffs;
+		result.firstMoveCutoffs += workerResult.firstMoveCutoffs;
+	}
+	result.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - shared.startTime).count();
+	result.nps = result.timeMs > 0 ? result.nodes * 1000 / result.timeMs : result.nodes;
+	result.hashfull = tt.hashfull();
+	lastResult = result;
+	return result;
+}
+
+/**
+ * @brief  Soft and hard time limits for a move by `sideToMove`.
+ *
+ * A fixed move time is both limits. On a clock the soft limit is an even
+ * share of the time left over the moves still to play plus three quarters
+ * of the increment, and the hard limit is four times that. Neither may
+ * exceed a third of the time left, or all of it with one move to go, less
+ * MOVE_OVERHEAD_MS, so a move never risks the clock however the search goes.
+ */
+TimeBudget SearchLimits::timeBudget(int sideToMove) const {
+	TimeBudget budget;
+	int64_t timeLeft = sideToMove == WHITE ? whiteTimeMs : blackTimeMs;
+	int64_t increment = sideToMove == WHITE ? whiteIncrementMs : blackIncrementMs;
+	if (timeLeft > 0) {
+		int64_t available = std::max<int64_t>(timeLeft - MOVE_OVERHEAD_MS, 1);
+		int64_t movesLeft = movesToGo > 0 ? std::min(movesToGo, DEFAULT_MOVES_TO_GO) : DEFAULT_MOVES_TO_GO;
+		int64_t cap = movesLeft == 1 ? available : std::max<int64_t>(available / 3, 1);
+		budget.softMs = std::min(available / movesLeft + increment * 3 / 4, cap);
+		budget.hardMs = std::min(budget.softMs * 4, cap);
+		budget.softMs = std::max<int64_t>(budget.softMs, 1);
+	}
+	if (moveTimeMs > 0) {
+		budget.hardMs = budget.hardMs ? std::min(budget.hardMs, moveTimeMs) : moveTimeMs;
+		budget.softMs = 0;
+	}
+	return budget;
+}
+
+/**
+ * @brief  Searches for the best `n` moves in a FEN, as UCI strings, best first.
+ *
+ * Same contract as Stockfish::getBestMoves so either can drive the game.
+ */
+std::vector<std::string> Search::getBestMoves(const std::string& fen, int n) {
+	std::vector<std::string> bestMoves;
+	Position rootPosition;
+	if (!rootPosition.setFromFEN(fen)) return bestMoves;
+
+	SearchResult result = think(rootPosition, n);
+	for (Move move : result.bestMoves) bestMoves.push_back(Position::moveToUci(move));
+	return bestMoves;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Position.h"
+#include "SearchWorker.h"
+#include "TranspositionTable.h"
+
+/**
+ * @brief  Built-in engine, searching with one or more threads (Lazy SMP).
+ *
+ * Every thread runs the same iterative-deepening search on its own copy of
+ * the root position; they cooperate only through a transposition table that
+ * persists between calls. The main thread enforces the limits and its result
+ * is the one reported. It plays from any Position and can stand in for the
+ * external UCI engine through getBestMoves.
+ */
+class Search {
+public:
+	Search();
+
+	void setLimits(const SearchLimits& newLimits) {
+		limits = newLimits;
+	}
+	void setHashSize(size_t megabytes) {
+		tt.resize(megabytes);
+	}
+	void clearHash() {
+		tt.clear();
+	}
+	void setThreads(int count);
+	int getThreads() const {
+		return static_cast<int>(workers.size());
+	}
+
+	SearchResult think(const Position& rootPosition, int multiPV = 1);
+	std::vector<std::string> getBestMoves(const std::string& fen, int n);
+	void stop() {
+		shared.stop = true;
+	}
+
+	const SearchResult& getLastResult() const {
+		return lastResult;
+	}
+
+private:
+	SearchLimits limits;
+	TranspositionTable tt;
+	SharedSearchState shared;
+	std::vector<std::unique_ptr<SearchWorker>> workers;
+
+	SearchResult lastResult;
+};
@@ -0,0 +1,471 @@
+#include "SearchWorker.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "Evaluation.h"
+#include "MovePicker.h"
+
+namespace {
+	using Eval::PIECE_VALUES;
+
+	// Quiescence skips a capture that cannot lift the score to alpha even with this much to spare
+	constexpr int DELTA_MARGIN = 200;
+
+	// A best score this much below the last iteration's counts as a fail-low and earns more time
+	constexpr int FAIL_LOW_MARGIN = 30;
+
+	// Quiet moves searched before a cutoff that get their history lowered; later ones are left alone
+	constexpr int MAX_QUIETS_TRIED = 64;
+
+	// Check the clock every this many nodes; a power of two minus one
+	constexpr uint64_t TIME_CHECK_MASK = 2047;
+
+	int scoreToMate(int ply) {
+		return -VALUE_MATE + ply;
+	}
+
+	// Mate scores are stored relative to the node, not the root, so they stay valid at any ply
+	int scoreToTT(int score, int ply) {
+		return score >= VALUE_MATE_IN_MAX_PLY ? score + ply : score <= -VALUE_MATE_IN_MAX_PLY ? score - ply : score;
+	}
+
+	int scoreFromTT(int score, int ply) {
+		return score >= VALUE_MATE_IN_MAX_PLY ? score - ply : score <= -VALUE_MATE_IN_MAX_PLY ? score + ply : score;
+	}
+}
+
+SearchWorker::SearchWorker(int id, TranspositionTable& tt, SharedSearchState& shared)
+	: id(id), tt(tt), shared(shared), nodes(0), publishedNodes(0), betaCutoffs(0), firstMoveCutoffs(0), pvLength(), lastBestMove(NO_MOVE), lastBestScore(0), stableIterations(0) {
+}
+
+/**
+ * @brief  Runs iterative deepening from `rootPosition` until a limit is hit or the search is stopped.
+ *
+ * With multiPV > 1 each iteration searches the root once per line, excluding
+ * the moves already placed above it, so every reported score is exact. An
+ * iteration interrupted by the limits is discarded unless it is the first.
+ *
+ * Helper threads (id > 0) search a single line and odd ones start one ply
+ * deeper, so the threads spread over different depths and fill the shared
+ * transposition table with results the others can reuse.
+ */
+void SearchWorker::run(const Position& rootPosition, int multiPV) {
+	position = rootPosition;
+	useNnue = Nnue::isLoaded();
+	if (useNnue) Nnue::refresh(accumulators[0], position);
+	nodes = 0;
+	publishedNodes = 0;
+	betaCutoffs = 0;
+	firstMoveCutoffs = 0;
+	lastBestMove = NO_MOVE;
+	lastBestScore = 0;
+	stableIterations = 0;
+	ttStats = TTStats();
+	result = SearchResult();
+	clearOrdering();
+
+	Move moves[MAX_MOVES];
+	int count = position.generateLegalMoves(moves);
+	orderMoves(moves, count);
+	rootMoves.clear();
+	for (int i = 0; i < count; ++i) rootMoves.push_back({ moves[i], -VALUE_INFINITE, { moves[i] } });
+
+	int lines = std::min<int>(id == 0 ? std::max(multiPV, 1) : 1, static_cast<int>(rootMoves.size()));
+	int startDepth = 1 + (id & 1);
+
+	for (int depth = startDepth; depth <= shared.limits.depth && !rootMoves.empty(); ++depth) {
+		bool completed = true;
+		for (int pvIndex = 0; pvIndex < lines; ++pvIndex) {
+			searchRoot(depth, pvIndex);
+			if (shared.stop) {
+				completed = false;
+				break;
+			}
+		}
+		if (!completed && depth > startDepth) break;
+
+		result.depth = depth;
+		result.bestMoves.clear();
+		result.scores.clear();
+		for (int i = 0; i < lines; ++i) {
+			result.bestMoves.push_back(rootMoves[i].move);
+			result.scores.push_back(rootMoves[i].score);
+		}
+		result.pv = rootMoves[0].pv;
+
+		if (!completed) break;
+
+		// A forced mate has been found; deeper iterations cannot improve on it
+		if (id == 0 && std::abs(rootMoves[0].score) >= VALUE_MATE_IN_MAX_PLY && lines == 1) break;
+
+		if (id == 0 && !shouldStartIteration(depth, startDepth)) break;
+	}
+
+	result.nodes = nodes;
+	result.ttStats = ttStats;
+	result.betaCutoffs = betaCutoffs;
+	result.firstMoveCutoffs = firstMoveCutoffs;
+}
+
+/**
+ * @brief  Searches the root moves from `pvIndex` on and sorts them by score.
+ *
+ * Moves above `pvIndex` already own better lines in this iteration and are skipped.
+ */
+int SearchWorker::searchRoot(int depth, int pvIndex) {
+	int alpha = -VALUE_INFINITE, beta = VALUE_INFINITE;
+	keyStack[0] = position.getKey();
+	UndoInfo undo;
+
+	for (size_t i = pvIndex; i < rootMoves.size(); ++i) {
+		RootMove& rootMove = rootMoves[i];
+		makeMove(rootMove.move, undo, 0);
+		++nodes;
+
+		int score;
+		if (i == static_cast<size_t>(pvIndex)) {
+			score = -negamax(depth - 1, -beta, -alpha, 1, true);
+		}
+		else {
+			score = -negamax(depth - 1, -alpha - 1, -alpha, 1, true);
+			if (score > alpha && !shared.stop) score = -negamax(depth - 1, -beta, -alpha, 1, true);
+		}
+		position.unmakeMove(rootMove.move, undo);
+
+		if (shared.stop) return alpha;
+
+		if (score > alpha) {
+			alpha = score;
+			rootMove.score = score;
+			rootMove.pv.assign(1, rootMove.move);
+			rootMove.pv.insert(rootMove.pv.end(), pvTable[1], pvTable[1] + pvLength[1]);
+		}
+		else {
+			rootMove.score = -VALUE_INFINITE;
+		}
+	}
+
+	std::stable_sort(rootMoves.begin() + pvIndex, rootMoves.end(), [](const RootMove& a, const RootMove& b) {
+		return a.score > b.score;
+	});
+	return alpha;
+}
+
+/**
+ * @brief  Principal variation search with null-move pruning and late-move reductions.
+ */
+int SearchWorker::negamax(int depth, int alpha, int beta, int ply, bool allowNull) {
+	pvLength[ply] = 0;
+	if (shouldStop()) return 0;
+
+	keyStack[ply] = position.getKey();
+	if (position.getHalfmoveClock() >= 100 || isRepetition(ply) || position.hasInsufficientMaterial()) return 0;
+	if (ply >= MAX_PLY - 1) return evaluate(ply);
+
+	bool inCheck = position.inCheck();
+	if (inCheck) ++depth; // Check extension: never drop into quiescence while in check
+	if (depth <= 0) return quiescence(alpha, beta, ply);
+
+	bool isPvNode = beta - alpha > 1;
+	int originalAlpha = alpha;
+	UndoInfo undo;
+
+	TTData ttData;
+	Move ttMove = NO_MOVE;
+	if (tt.probe(position.getKey(), ttData, ttStats)) {
+		ttMove = ttData.move;
+		int ttScore = scoreFromTT(ttData.score, ply);
+		if (!isPvNode && ttData.depth >= depth
+			&& (ttData.bound == Bound::EXACT
+				|| (ttData.bound == Bound::LOWER && ttScore >= beta)
+				|| (ttData.bound == Bound::UPPER && ttScore <= alpha))) {
+			return ttScore;
+		}
+	}
+
+	// Null move: if passing still fails high, a real move almost surely does too
+	if (allowNull && !isPvNode && !inCheck && depth >= 3 && std::abs(beta) < VALUE_MATE_IN_MAX_PLY) {
+		int us = static_cast<int>(position.sideToMove());
+		bool hasPieces = position.piecesOf(us) != (position.pieces(us, PAWN) | position.pieces(us, KING));
+		if (hasPieces && evaluate(ply) >= beta) {
+			int reduction = 2 + depth / 4;
+			makeNullMove(undo, ply);
+			int score = -negamax(depth - 1 - reduction, -beta, -beta + 1, ply + 1, false);
+			position.unmakeNullMove(undo);
+			if (shared.stop) return 0;
+			if (score >= beta) return score >= VALUE_MATE_IN_MAX_PLY ? beta : score;
+		}
+	}
+
+	Move previous = moveStack[ply - 1];
+	Move counterMove = previous == NO_MOVE ? NO_MOVE : counterMoves[position.pieceOn(previous.to())][previous.to()];
+	MovePicker picker(position, ttMove, killers[ply], counterMove, history);
+
+	Move quietsTried[MAX_QUIETS_TRIED];
+	int quietCount = 0;
+	int moveCount = 0;
+	int bestScore = -VALUE_INFINITE;
+	Move bestMove = NO_MOVE;
+	for (Move move; (move = picker.next()) != NO_MOVE;) {
+		bool quiet = !position.isTactical(move);
+		int index = moveCount++;
+
+		makeMove(move, undo, ply);
+		++nodes;
+		bool givesCheck = position.inCheck();
+
+		int score;
+		if (index == 0) {
+			score = -negamax(depth - 1, -beta, -alpha, ply + 1, true);
+		}
+		else {
+			// Late quiet moves are searched shallower first and only re-searched if they surprise
+			int reduction = 0;
+			if (depth >= 3 && index >= 3 && quiet && !inCheck && !givesCheck) {
+				reduction = index >= 6 && depth >= 6 ? 2 : 1;
+			}
+			score = -negamax(depth - 1 - reduction, -alpha - 1, -alpha, ply + 1, true);
+			if (score > alpha && reduction > 0) {
+				score = -negamax(depth - 1, -alpha - 1, -alpha, ply + 1, true);
+			}
+			if (score > alpha && score < beta) {
+				score = -negamax(depth - 1, -beta, -alpha, ply + 1, true);
+			}
+		}
+		position.unmakeMove(move, undo);
+
+		if (shared.stop) return 0;
+
+		if (score > bestScore) {
+			bestScore = score;
+			if (score > alpha) {
+				alpha = score;
+				bestMove = move;
+				updatePv(ply, move);
+				if (alpha >= beta) {
+					++betaCutoffs;
+					if (index == 0) ++firstMoveCutoffs;
+					if (quiet) updateOrdering(move, ply, depth, quietsTried, quietCount);
+					break;
+				}
+			}
+		}
+		if (quiet && quietCount < MAX_QUIETS_TRIED) quietsTried[quietCount++] = move;
+	}
+	if (moveCount == 0) return inCheck ? scoreToMate(ply) : 0;
+
+	Bound bound = bestScore >= beta ? Bound::LOWER : alpha > originalAlpha ? Bound::EXACT : Bound::UPPER;
+	tt.store(position.getKey(), bestMove, scoreToTT(bestScore, ply), depth, bound, ttStats);
+	return bestScore;
+}
+
+/**
+ * @brief  Resolves captures and queen promotions at the horizon so the static evaluation is only taken in quiet positions.
+ *
+ * Captures that lose material by static exchange evaluation are skipped,
+ * and so are captures whose victim is too small to bring the score back
+ * to alpha (delta pruning).
+ */
+int SearchWorker::quiescence(int alpha, int beta, int ply) {
+	pvLength[ply] = 0;
+	if (shouldStop()) return 0;
+
+	int standPat = evaluate(ply);
+	if (ply >= MAX_PLY - 1 || standPat >= beta) return standPat;
+	if (standPat > alpha) alpha = standPat;
+
+	MovePicker picker(position);
+	UndoInfo undo;
+	for (Move move; (move = picker.next()) != NO_MOVE;) {
+		if (move.flag() != MoveFlag::PROMOTION) {
+			int victim = move.flag() == MoveFlag::EN_PASSANT ? PAWN : kindOf(position.pieceOn(move.to()));
+			if (standPat + PIECE_VALUES[victim] + DELTA_MARGIN <= alpha) continue;
+		}
+
+		makeMove(move, undo, ply);
+		++nodes;
+		int score = -quiescence(-beta, -alpha, ply + 1);
+		position.unmakeMove(move, undo);
+
+		if (shared.stop) return 0;
+		if (score > alpha) {
+			alpha = score;
+			if (alpha >= beta) break;
+		}
+	}
+	return alpha;
+}
+
+/**
+ * @brief  Static score from the side to move's point of view: the NNUE network if loaded, else tapered piece-square tables.
+ */
+int SearchWorker::evaluate(int ply) const {
+	return useNnue ? Nnue::evaluate(accumulators[ply], static_cast<int>(position.sideToMove())) : position.evaluate();
+}
+
+/**
+ * @brief  Plays a move found at `ply`, bringing the accumulator of the next ply up to date first.
+ */
+void SearchWorker::makeMove(Move move, UndoInfo& undo, int ply) {
+	moveStack[ply] = move;
+	if (useNnue) Nnue::update(accumulators[ply + 1], accumulators[ply], position, move);
+	position.makeMove(move, undo);
+}
+
+void SearchWorker::makeNullMove(UndoInfo& undo, int ply) {
+	moveStack[ply] = NO_MOVE;
+	if (useNnue) accumulators[ply + 1] = accumulators[ply];
+	position.makeNullMove(undo);
+}
+
+bool SearchWorker::isCapture(Move move) const {
+	return position.pieceOn(move.to()) != NO_PIECE || move.flag() == MoveFlag::EN_PASSANT;
+}
+
+/**
+ * @brief  Orders the root moves for the first iteration: promotions and captures by MVV-LVA, then quiets.
+ *
+ * Later iterations sort the root moves by their scores instead, and every
+ * other node uses a MovePicker.
+ */
+void SearchWorker::orderMoves(Move* moves, int count) const {
+	int scores[MAX_MOVES];
+	for (int i = 0; i < count; ++i) {
+		Move move = moves[i];
+		int score = 0;
+		if (move.flag() == MoveFlag::PROMOTION) score += 50000 + PIECE_VALUES[move.promotion()];
+		if (isCapture(move)) {
+			int victim = move.flag() == MoveFlag::EN_PASSANT ? PAWN : kindOf(position.pieceOn(move.to()));
+			score += 100000 + PIECE_VALUES[victim] * 10 - kindOf(position.pieceOn(move.from()));
+		}
+		scores[i] = score;
+	}
+
+	// Insertion sort: move lists are short and mostly quiet moves with equal scores
+	for (int i = 1; i < count; ++i) {
+		Move move = moves[i];
+		int score = scores[i];
+		int j = i - 1;
+		while (j >= 0 && scores[j] < score) {
+			moves[j + 1] = moves[j];
+			scores[j + 1] = scores[j];
+			--j;
+		}
+		moves[j + 1] = move;
+		scores[j + 1] = score;
+	}
+}
+
+void SearchWorker::clearOrdering() {
+	std::fill(&killers[0][0], &killers[0][0] + MAX_PLY * 2, NO_MOVE);
+	std::fill(&counterMoves[0][0], &counterMoves[0][0] + PIECE_NB * SQUARE_NB, NO_MOVE);
+	std::fill(&history[0][0][0], &history[0][0][0] + 2 * SQUARE_NB * SQUARE_NB, static_cast<int16_t>(0));
+}
+
+/**
+ * @brief  Rewards a quiet move that caused a beta cutoff and penalises the quiet moves tried before it.
+ *
+ * The move becomes the first killer at this ply and the countermove to
+ * the previous move. History bonuses grow with depth and shrink as an
+ * entry nears HISTORY_MAX, so no entry can overflow.
+ */
+void SearchWorker::updateOrdering(Move move, int ply, int depth, const Move* quietsTried, int quietCount) {
+	if (killers[ply][0] != move) {
+		killers[ply][1] = killers[ply][0];
+		killers[ply][0] = move;
+	}
+	Move previous = moveStack[ply - 1];
+	if (previous != NO_MOVE) counterMoves[position.pieceOn(previous.to())][previous.to()] = move;
+
+	int us = static_cast<int>(position.sideToMove());
+	int bonus = std::min(depth * depth, HISTORY_MAX);
+	auto update = [&](Move quiet, int change) {
+		int16_t& entry = history[us][quiet.from()][quiet.to()];
+		entry = static_cast<int16_t>(entry + change - entry * std::abs(change) / HISTORY_MAX);
+	};
+	update(move, bonus);
+	for (int i = 0; i < quietCount; ++i) update(quietsTried[i], -bonus);
+}
+
+/**
+ * @brief  True if the current position already occurred since the last irreversible move.
+ *
+ * Looks back along the search path and then into the game before the root
+ * (SearchLimits::gameKeys). The scan stops at a null move: the positions
+ * before it cannot be reached again by real moves.
+ */
+bool SearchWorker::isRepetition(int ply) const {
+	const std::vector<uint64_t>& gameKeys = shared.limits.gameKeys;
+	int reversible = std::min(position.getHalfmoveClock(), ply + static_cast<int>(gameKeys.size()));
+	for (int distance = 1; distance <= reversible; ++distance) {
+		int earlier = ply - distance;
+		if (earlier >= 0 && moveStack[earlier] == NO_MOVE) return false;
+		if (distance < 4 || distance % 2 != 0) continue;
+
+		uint64_t key = earlier >= 0 ? keyStack[earlier] : gameKeys[gameKeys.size() + earlier];
+		if (key == keyStack[ply]) return true;
+	}
+	return false;
+}
+
+/**
+ * @brief  Polled at every node.
+ *
+ * Every TIME_CHECK_MASK + 1 nodes the local count is added to the shared
+ * total, and the main thread checks the node and time limits.
+ */
+bool SearchWorker::shouldStop() {
+	if (shared.stop.load(std::memory_order_relaxed)) return true;
+	if ((nodes & TIME_CHECK_MASK) != 0 || nodes == publishedNodes) return false;
+
+	uint64_t delta = nodes - publishedNodes;
+	uint64_t totalNodes = shared.nodes.fetch_add(delta, std::memory_order_relaxed) + delta;
+	publishedNodes = nodes;
+	if (id != 0) return false;
+
+	const SearchLimits& limits = shared.limits;
+	if (limits.nodes && totalNodes >= limits.nodes) {
+		shared.stop = true;
+	}
+	else if (shared.time.hardMs && elapsedMs() >= shared.time.hardMs) {
+		shared.stop = true;
+	}
+	return shared.stop;
+}
+
+/**
+ * @brief  Called by the main thread after each iteration: whether to search one ply deeper under the soft time limit.
+ *
+ * The target starts at the soft limit. It shrinks while the best move
+ * stays the same from one iteration to the next, and doubles when the
+ * best score drops by FAIL_LOW_MARGIN or more, since a better move may
+ * still turn up. The hard limit always caps it. The next iteration
+ * usually takes about as long as all the earlier ones together, so none
+ * is started after half the target.
+ */
+bool SearchWorker::shouldStartIteration(int depth, int startDepth) {
+	const RootMove& best = rootMoves[0];
+	bool failedLow = depth > startDepth && best.score <= lastBestScore - FAIL_LOW_MARGIN;
+	stableIterations = best.move == lastBestMove ? stableIterations + 1 : 0;
+	lastBestMove = best.move;
+	lastBestScore = best.score;
+	if (!shared.time.softMs) return true;
+
+	int64_t target = shared.time.softMs;
+	if (failedLow) target *= 2;
+	else if (stableIterations >= 4) target = target * 2 / 5;
+	else if (stableIterations >= 2) target = target * 7 / 10;
+	if (shared.time.hardMs) target = std::min(target, shared.time.hardMs);
+	return elapsedMs() * 2 < target;
+}
+
+int64_t SearchWorker::elapsedMs() const {
+	return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - shared.startTime).count();
+}
+
+void SearchWorker::updatePv(int ply, Move move) {
+	pvTable[ply][0] = move;
+	std::copy(pvTable[ply + 1], pvTable[ply + 1] + pvLength[ply + 1], pvTable[ply] + 1);
+	pvLength[ply] = pvLength[ply + 1] + 1;
+}
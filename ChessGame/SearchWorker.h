@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "MovePicker.h"
+#include "Nnue.h"
+#include "Position.h"
+#include "TranspositionTable.h"
+
+constexpr int MAX_PLY = 128;
+constexpr int VALUE_INFINITE = 32001;
+constexpr int VALUE_MATE = 32000;
+constexpr int VALUE_MATE_IN_MAX_PLY = VALUE_MATE - MAX_PLY;
+
+/**
+ * @brief  Time one move may take, in milliseconds; zero for no limit.
+ *
+ * No new iteration is started once the soft limit makes finishing it
+ * unlikely; the hard limit stops the search wherever it is.
+ */
+struct TimeBudget {
+	int64_t softMs = 0;
+	int64_t hardMs = 0;
+};
+
+/**
+ * @brief  When to stop thinking. Zero means "no limit" for time and nodes.
+ *
+ * Instead of a fixed move time the search can be given the game clock, in
+ * the same terms as a UCI "go wtime btime winc binc movestogo", and budget
+ * the time of each move itself.
+ */
+struct SearchLimits {
+	int depth = MAX_PLY - 1;
+	int64_t moveTimeMs = 0;
+	uint64_t nodes = 0;
+	int64_t whiteTimeMs = 0;
+	int64_t blackTimeMs = 0;
+	int64_t whiteIncrementMs = 0;
+	int64_t blackIncrementMs = 0;
+	int movesToGo = 0;
+	std::vector<uint64_t> gameKeys;  // Keys of the game's positions before the root since the last irreversible move, oldest first
+
+	TimeBudget timeBudget(int sideToMove) const;
+};
+
+struct SearchResult {
+	std::vector<Move> bestMoves;   // Best first, one per requested line
+	std::vector<int> scores;       // Centipawns from the side to move's view, parallel to bestMoves
+	std::vector<Move> pv;          // Principal variation of the best line
+	int depth = 0;                 // Last fully completed iteration
+	uint64_t nodes = 0;
+	int64_t timeMs = 0;
+	uint64_t nps = 0;
+	TTStats ttStats;
+	int hashfull = 0;              // Permille of the transposition table used by this search
+	uint64_t betaCutoffs = 0;      // Nodes that failed high outside the root
+	uint64_t firstMoveCutoffs = 0; // Of those, the ones where the first move searched was enough
+	std::vector<uint64_t> threadNodes;  // Nodes searched by each thread, main thread first
+};
+
+/**
+ * @brief  State every search thread reads while a search is running.
+ */
+struct SharedSearchState {
+	SearchLimits limits;
+	TimeBudget time;
+	std::chrono::steady_clock::time_point startTime;
+	std::atomic<bool> stop{ false };
+	std::atomic<uint64_t> nodes{ 0 };  // Published in batches, so it trails the true total slightly
+};
+
+/**
+ * @brief  One search thread: iterative-deepening negamax with alpha-beta.
+ *
+ * Uses principal variation search, null-move pruning, late-move reductions
+ * and a quiescence search over captures and queen promotions, pruned by
+ * static exchange evaluation and delta pruning. Moves are tried in the
+ * order a MovePicker gives them, fed by killer, countermove and history
+ * tables that start empty with every search. Each worker owns a copy of
+ * the root Position and all of its search stacks and ordering tables; the
+ * only things shared with other workers are the transposition table and
+ * the SharedSearchState.
+ */
+class SearchWorker {
+public:
+	SearchWorker(int id, TranspositionTable& tt, SharedSearchState& shared);
+
+	void run(const Position& rootPosition, int multiPV);
+
+	const SearchResult& getResult() const {
+		return result;
+	}
+
+private:
+	struct RootMove {
+		Move move;
+		int score;
+		std::vector<Move> pv;
+	};
+
+	int searchRoot(int depth, int pvIndex);
+	int negamax(int depth, int alpha, int beta, int ply, bool allowNull);
+	int quiescence(int alpha, int beta, int ply);
+	int evaluate(int ply) const;
+	void makeMove(Move move, UndoInfo& undo, int ply);
+	void makeNullMove(UndoInfo& undo, int ply);
+
+	void orderMoves(Move* moves, int count) const;
+	void clearOrdering();
+	void updateOrdering(Move move, int ply, int depth, const Move* quietsTried, int quietCount);
+	bool isCapture(Move move) const;
+	bool isRepetition(int ply) const;
+	bool shouldStop();
+	bool shouldStartIteration(int depth, int startDepth);
+	int64_t elapsedMs() const;
+	void updatePv(int ply, Move move);
+
+	int id;
+	TranspositionTable& tt;
+	SharedSearchState& shared;
+
+	Position position;
+	uint64_t nodes;
+	uint64_t publishedNodes;
+	TTStats ttStats;
+	uint64_t betaCutoffs;
+	uint64_t firstMoveCutoffs;
+
+	std::vector<RootMove> rootMoves;
+	Move pvTable[MAX_PLY][MAX_PLY];
+	int pvLength[MAX_PLY];
+	uint64_t keyStack[MAX_PLY + 1];
+	Move moveStack[MAX_PLY];  // Move played at each ply, NO_MOVE for a null move
+
+	// Best move and score of the last iteration, and for how many iterations that move has stayed best
+	Move lastBestMove;
+	int lastBestScore;
+	int stableIterations;
+
+	// Move ordering: killers by ply, countermoves by the piece and square of the move they answer
+	Move killers[MAX_PLY][2];
+	Move counterMoves[PIECE_NB][SQUARE_NB];
+	ButterflyHistory history;
+
+	// NNUE accumulator of the position at each ply, used while a network is loaded
+	bool useNnue = false;
+	Nnue::Accumulator accumulators[MAX_PLY + 1];
+
+	SearchResult result;
+};
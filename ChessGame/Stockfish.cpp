@@ -1,129 +1,195 @@
 #include "Stockfish.h"
 
+#include <algorithm>
+#include <chrono>
+#include <utility>
+
+namespace {
+    // Longest a read blocks before the caller gets to check for a stop or timeout
+    constexpr int READ_TICK_MS = 20;
+
+    // Longest the engine may take to answer uci or isready before it is given up on
+    constexpr auto REPLY_TIMEOUT = std::chrono::seconds(10);
+}
 
 Stockfish::Stockfish(const std::string& path) : stockfishPath(path) {
     startStockfish();
 }
 
-Stockfish::~Stockfish() {
-    sendCommand("quit");
-    CloseHandle(piProcInfo.hProcess);
-    CloseHandle(piProcInfo.hThread);
-    CloseHandle(hChildStd_IN_Wr);
-    CloseHandle(hChildStd_OUT_Rd);
+/**
+ * @brief  Called once by the backend after the process starts: waits for `uciok` and `readyok`.
+ */
+void Stockfish::handshake() {
+    sendCommand("uci");
+    readUntil("uciok");
+    waitUntilReady();
 }
-#include <windows.h>
-#include <iostream>
-#include <vector>
-
-void Stockfish::startStockfish() {
-    SECURITY_ATTRIBUTES saAttr;
-    saAttr.nLength = sizeof(SECURITY_ATTRIBUTES);
-    saAttr.bInheritHandle = TRUE;
-    saAttr.lpSecurityDescriptor = NULL;
-
-    CreatePipe(&hChildStd_OUT_Rd, &hChildStd_OUT_Wr, &saAttr, 0);
-    CreatePipe(&hChildStd_IN_Rd, &hChildStd_IN_Wr, &saAttr, 0);
-
-    ZeroMemory(&piProcInfo, sizeof(PROCESS_INFORMATION));
-    ZeroMemory(&siStartInfo, sizeof(STARTUPINFO));
-    siStartInfo.cb = sizeof(STARTUPINFO);
-    siStartInfo.hStdError = hChildStd_OUT_Wr;
-    siStartInfo.hStdOutput = hChildStd_OUT_Wr;
-    siStartInfo.hStdInput = hChildStd_IN_Rd;
-    siStartInfo.dwFlags |= STARTF_USESTDHANDLES;
-
-    // Convert std::string to std::wstring using MultiByteToWideChar
-    int size_needed = MultiByteToWideChar(CP_UTF8, 0, stockfishPath.c_str(), -1, NULL, 0);
-    std::wstring wStockfishPath(size_needed, 0);
-    MultiByteToWideChar(CP_UTF8, 0, stockfishPath.c_str(), -1, &wStockfishPath[0], size_needed);
-
-    // Use CreateProcessW with wide-character string
-    if (!CreateProcessW(wStockfishPath.c_str(), NULL, NULL, NULL, TRUE, 0, NULL, NULL, &siStartInfo, &piProcInfo)) {
-        std::cerr << "Failed to start Stockfish!" << std::endl;
-        return;
-    }
 
-    sendCommand("uci");
+void Stockfish::waitUntilReady() {
     sendCommand("isready");
+    readUntil("readyok");
 }
 
+/**
+ * @brief  Feeds each complete line of engine output to `onLine` until it returns true.
+ *
+ * Lines are handed out as views into a buffer that only ever holds the
+ * current chunk and a partial line, so memory does not grow with the length
+ * of the search. Trailing carriage returns are stripped. `shouldAbort` is
+ * polled at least every READ_TICK_MS while waiting for output.
+ *
+ * Returns false if the engine exits or `shouldAbort` returns true first.
+ */
+bool Stockfish::readLines(const std::function<bool(std::string_view)>& onLine, const std::function<bool()>& shouldAbort) {
+    size_t lineStart = 0;
+    size_t scanFrom = 0;
 
-
-void Stockfish::sendCommand(const std::string& command) {
-    std::string cmd = command + "\n";
-    DWORD written;
-    WriteFile(hChildStd_IN_Wr, cmd.c_str(), cmd.length(), &written, NULL);
+    while (true) {
+        size_t lineEnd;
+        while ((lineEnd = lineBuffer.find('\n', scanFrom)) != std::string::npos) {
+            std::string_view line(lineBuffer.data() + lineStart, lineEnd - lineStart);
+            if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+            lineStart = scanFrom = lineEnd + 1;
+            if (onLine(line)) {
+                lineBuffer.erase(0, lineStart);
+                return true;
+            }
+        }
+        lineBuffer.erase(0, lineStart);
+        scanFrom = lineBuffer.size();
+        lineStart = 0;
+        if (shouldAbort && shouldAbort()) return false;
+        if (!running || !readChunk(lineBuffer, READ_TICK_MS)) return false;
+    }
 }
 
-std::string Stockfish::readOutput() {
-    DWORD bytesRead;
-    CHAR buffer[4096];
-    std::string output;
-
-    while (true) {
-        ReadFile(hChildStd_OUT_Rd, buffer, sizeof(buffer) - 1, &bytesRead, NULL);
-        if (bytesRead == 0) break;
-        buffer[bytesRead] = '\0';
-        output += buffer;
-        if (output.find("bestmove") != std::string::npos) break;
+/**
+ * @brief  Skips output up to the first line starting with `token`.
+ *
+ * An engine that does not send it within REPLY_TIMEOUT is treated as dead.
+ */
+void Stockfish::readUntil(const std::string& token) {
+    auto deadline = std::chrono::steady_clock::now() + REPLY_TIMEOUT;
+    bool found = readLines([&](std::string_view line) {
+        return Uci::startsWith(line, token);
+    }, [&]() {
+        return std::chrono::steady_clock::now() >= deadline;
+    });
+
+    if (!found && running) {
+        std::cerr << "Stockfish did not answer with " << token << std::endl;
+        killStockfish();
     }
+}
 
-    return output;
+/**
+ * @brief  Sets a UCI option, sending it only if it differs from the value last sent.
+ */
+void Stockfish::setOption(const std::string& name, const std::string& value) {
+    auto it = options.find(name);
+    if (it != options.end() && it->second == value) return;
+
+    options[name] = value;
+    sendCommand("setoption name " + name + " value " + value);
 }
 
-std::vector<std::string> Stockfish::getBestMoves(const std::string& fen, int n) {
-    sendCommand("uci");       // Ensure Stockfish is initialized
-    sendCommand("isready");   // Ensure it's ready before sending a new position
-    sendCommand("setoption name MultiPV value " + std::to_string(n));  // Set MultiPV explicitly
-    sendCommand("position fen " + fen);
-    sendCommand("go depth 20");  // No need for multipv here since it's set globally
-
-    std::string output = readOutput();
-    std::unordered_map<int, std::string> bestMovesMap;  // Store moves by their multipv index
-    std::istringstream iss(output);
-    std::string line;
-    int highestDepth = 0;
-
-    while (std::getline(iss, line)) {
-        if (line.find("info depth") != std::string::npos && line.find(" multipv ") != std::string::npos) {
-            std::istringstream lineStream(line);
-            std::string token;
-            int depth = 0, multipv = 0;
-            std::string move;
-
-            while (lineStream >> token) {
-                if (token == "depth") {
-                    lineStream >> depth;
-                }
-                else if (token == "multipv") {
-                    lineStream >> multipv;
-                }
-                else if (token == "pv") {
-                    lineStream >> move;
-                    break;
-                }
-            }
+void Stockfish::setInfoCallback(InfoCallback callback) {
+    infoCallback = std::move(callback);
+}
 
-            if (!move.empty() && multipv > 0 && multipv <= n) {
-                bestMovesMap[multipv] = move;  // Store move indexed by multipv
-                highestDepth = std::max<int>(highestDepth, depth);
-            }
-        }
-    }
+/**
+ * @brief  Tells the engine the next position belongs to a new game and waits until it has reset.
+ */
+void Stockfish::newGame() {
+    if (!running) return;
+    sendCommand("ucinewgame");
+    waitUntilReady();
+}
 
-    // Ensure only `N` moves are returned, sorted by multipv order
-    std::vector<std::string> bestMoves;
-    for (int i = 1; i <= n; i++) {
-        if (bestMovesMap.find(i) != bestMovesMap.end()) {
-            bestMoves.push_back(bestMovesMap[i]);
-        }
+/**
+ * @brief  The "go" command for these limits. With no limit and no clock set the engine searches to depth 20.
+ */
+std::string UciLimits::goCommand() const {
+    std::string command = "go";
+    if (depth > 0) command += " depth " + std::to_string(depth);
+    if (moveTimeMs > 0) command += " movetime " + std::to_string(moveTimeMs);
+    if (nodes > 0) command += " nodes " + std::to_string(nodes);
+    if (whiteTimeMs > 0 || blackTimeMs > 0) {
+        command += " wtime " + std::to_string(std::max<int64_t>(whiteTimeMs, 1)) + " btime " + std::to_string(std::max<int64_t>(blackTimeMs, 1));
+        if (whiteIncrementMs > 0) command += " winc " + std::to_string(whiteIncrementMs);
+        if (blackIncrementMs > 0) command += " binc " + std::to_string(blackIncrementMs);
+        if (movesToGo > 0) command += " movestogo " + std::to_string(movesToGo);
     }
-
-    return bestMoves;
+    return command == "go" ? "go depth 20" : command;
 }
 
+/**
+ * @brief  Searches `fen` and returns up to `multiPV` lines, best first. Blocks until bestmove.
+ */
+UciAnalysis Stockfish::analyze(const std::string& fen, int multiPV, const UciLimits& limits) {
+    return runSearch("position fen " + fen, multiPV, limits.goCommand(), nullptr);
+}
 
+/**
+ * @brief  Sends one position and go command, then collects the search output until bestmove.
+ *
+ * Each info line is parsed as it arrives and handed to the info callback,
+ * so the caller can show live analysis; only the latest result per line is
+ * kept. If `shouldAbort` returns true the reading stops and the engine
+ * process is killed and reaped, since a late bestmove would otherwise be
+ * taken as the answer to the next search.
+ */
+UciAnalysis Stockfish::runSearch(const std::string& positionCommand, int multiPV, const std::string& goCommand, const std::function<bool()>& shouldAbort) {
+    UciAnalysis analysis;
+    if (!running) return analysis;
+
+    multiPV = std::max<int>(multiPV, 1);
+    setOption("MultiPV", std::to_string(multiPV));
+    sendCommand(positionCommand);
+    sendCommand(goCommand);
+
+    analysis.lines.resize(multiPV);
+    Uci::Info info;
+    bool finished = readLines([&](std::string_view line) {
+        if (Uci::parseInfo(line, info)) {
+            if (!info.bestMove.empty() && info.multipv > 0 && info.multipv <= multiPV) {
+                UciLine& pvLine = analysis.lines[info.multipv - 1];
+                pvLine.move.assign(info.bestMove.data(), info.bestMove.size());
+                pvLine.score = info.score;
+                pvLine.isMate = info.isMate;
+                if (info.multipv == 1) analysis.depth = info.depth;
+            }
+            if (info.nodes) analysis.nodes = info.nodes;
+            if (infoCallback) infoCallback(info);
+            return false;
+        }
+        std::string_view bestMove, ponderMove;
+        if (Uci::parseBestMove(line, bestMove, ponderMove)) {
+            analysis.ponderMove.assign(ponderMove.data(), ponderMove.size());
+            // An engine stopped before its first PV still names its move here
+            if (analysis.lines[0].move.empty() && bestMove != "(none)") analysis.lines[0].move.assign(bestMove.data(), bestMove.size());
+            return true;
+        }
+        return false;
+    }, shouldAbort);
 
+    // An engine that exited, or never answered "stop", must not be left running or unreaped
+    if (!finished) killStockfish();
+    analysis.completed = finished;
 
+    // Drop lines the engine never reported, e.g. when there are fewer legal moves than `multiPV`
+    analysis.lines.erase(std::remove_if(analysis.lines.begin(), analysis.lines.end(),
+        [](const UciLine& pvLine) { return pvLine.move.empty(); }), analysis.lines.end());
+    return analysis;
+}
 
+/**
+ * @brief  Searches `fen` to depth 20 and returns up to `n` best moves, best first.
+ */
+std::vector<std::string> Stockfish::getBestMoves(const std::string& fen, int n) {
+    UciLimits limits;
+    limits.depth = 20;
+    std::vector<std::string> bestMoves;
+    for (const UciLine& line : analyze(fen, n, limits).lines) bestMoves.push_back(line.move);
+    return bestMoves;
+}
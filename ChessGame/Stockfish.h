@@ -1,28 +1,112 @@
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <vector>
-#include <windows.h>
 #include <iostream>
 #include <sstream>
 #include <unordered_map>
 
+#include "UciParser.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <sys/types.h>
+#endif
+
+/**
+ * @brief  Limits for one "go" command. Zero means "no limit"; the engine stops at the first one reached.
+ *
+ * With a clock time set the engine budgets its own time for the move from
+ * both clocks, the increments and, if nonzero, the moves to the next time control.
+ */
+struct UciLimits {
+    int depth = 0;
+    int64_t moveTimeMs = 0;
+    uint64_t nodes = 0;
+    int64_t whiteTimeMs = 0;
+    int64_t blackTimeMs = 0;
+    int64_t whiteIncrementMs = 0;
+    int64_t blackIncrementMs = 0;
+    int movesToGo = 0;
+
+    std::string goCommand() const;
+};
+
+struct UciLine {
+    std::string move;
+    int score = 0;        // Centipawns, or moves to mate when isMate, from the side to move's view
+    bool isMate = false;
+};
+
+struct UciAnalysis {
+    std::vector<UciLine> lines;  // Best first, one per MultiPV line
+    std::string ponderMove;      // Reply the engine expects, empty if it did not say
+    int depth = 0;
+    uint64_t nodes = 0;
+    bool completed = false;      // False if the engine exited or hung before sending bestmove
+};
 
+/**
+ * @brief  Bridge to an external UCI engine running as a child process.
+ *
+ * The UCI conversation lives in Stockfish.cpp; starting the process and
+ * moving bytes over its pipes is done by a platform backend chosen at build
+ * time: StockfishWin32.cpp on Windows, StockfishPosix.cpp everywhere else.
+ *
+ * The session is long-lived: the uci/isready handshake happens once at
+ * startup, options are only resent when their value changes, and
+ * `ucinewgame` is sent by newGame() between games rather than per move.
+ */
 class Stockfish {
 private:
     std::string stockfishPath;
+#if defined(_WIN32)
     HANDLE hChildStd_IN_Rd = NULL, hChildStd_IN_Wr = NULL;
     HANDLE hChildStd_OUT_Rd = NULL, hChildStd_OUT_Wr = NULL;
     PROCESS_INFORMATION piProcInfo;
     STARTUPINFO siStartInfo;
+#else
+    pid_t childPid = -1;
+    int childStdin = -1;     // Write end of the engine's stdin
+    int childStdout = -1;    // Non-blocking read end of the engine's stdout and stderr
+#endif
+    std::atomic<bool> running{ false };
+    std::mutex writeMutex;      // stop and ponderhit are sent from other threads mid-search
+    std::string lineBuffer;     // Engine output not yet consumed as complete lines
+    std::unordered_map<std::string, std::string> options;  // Values last sent with setoption
+    std::function<void(const Uci::Info&)> infoCallback;  // Called from getBestMoves for every info line
 
+    // Platform backend
     void startStockfish();
+    void killStockfish();
     void sendCommand(const std::string& command);
-    std::string readOutput();
+    bool readChunk(std::string& output, int timeoutMs);
+
+    void handshake();
+    void waitUntilReady();
+    bool readLines(const std::function<bool(std::string_view)>& onLine, const std::function<bool()>& shouldAbort = nullptr);
+    void readUntil(const std::string& token);
+    UciAnalysis runSearch(const std::string& positionCommand, int multiPV, const std::string& goCommand, const std::function<bool()>& shouldAbort);
+
+    friend class EngineRequest;
 
 public:
+    using InfoCallback = std::function<void(const Uci::Info&)>;
+
     Stockfish(const std::string& path);
     ~Stockfish();
+    void setOption(const std::string& name, const std::string& value);
+    void setInfoCallback(InfoCallback callback);
+    void newGame();
+    UciAnalysis analyze(const std::string& fen, int multiPV, const UciLimits& limits);
     std::vector<std::string> getBestMoves(const std::string& fen, int n);
+    bool isRunning() const {
+        return running;
+    }
 };
-
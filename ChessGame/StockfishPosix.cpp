@@ -0,0 +1,245 @@
+#include "Stockfish.h"
+
+#if !defined(_WIN32)
+
+#include <cerrno>
+#include <csignal>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+#if defined(__linux__) || defined(__FreeBSD__) || defined(__NetBSD__) || defined(__OpenBSD__)
+#define STOCKFISH_HAS_PIPE2 1
+#endif
+
+namespace {
+    // How long the engine gets to exit after "quit" before it is killed
+    constexpr auto QUIT_GRACE_PERIOD = std::chrono::milliseconds(500);
+
+#if defined(STOCKFISH_HAS_PIPE2)
+    constexpr bool HAS_PIPE2 = true;
+#else
+    constexpr bool HAS_PIPE2 = false;
+#endif
+
+    /*
+     * Without pipe2 a pipe is created inheritable and only marked close-on-exec
+     * afterwards. Engines are started from several threads at once (EnginePool),
+     * so this is held from pipe creation until the parent has closed the
+     * child's ends; otherwise another engine could inherit them, and a dead
+     * engine's stdout would never read as end-of-file.
+     */
+    std::mutex spawnMutex;
+
+    bool openPipe(int fds[2]) {
+#if defined(STOCKFISH_HAS_PIPE2)
+        return pipe2(fds, O_CLOEXEC) == 0;
+#else
+        if (pipe(fds) != 0) return false;
+        fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+        return true;
+#endif
+    }
+
+    void closeFd(int& fd) {
+        if (fd >= 0) close(fd);
+        fd = -1;
+    }
+
+#if !defined(F_SETNOSIGPIPE)
+    /*
+     * Blocks SIGPIPE on the calling thread while alive. A write to an engine
+     * that has exited then fails with EPIPE; the signal it leaves pending is
+     * discarded before the mask is restored, so it is never delivered and
+     * the game's own SIGPIPE handling stays untouched.
+     */
+    class ScopedSigpipeBlock {
+    public:
+        ScopedSigpipeBlock() {
+            sigemptyset(&pipeSignal);
+            sigaddset(&pipeSignal, SIGPIPE);
+            sigset_t pending;
+            sigpending(&pending);
+            alreadyPending = sigismember(&pending, SIGPIPE) == 1;
+            pthread_sigmask(SIG_BLOCK, &pipeSignal, &previousMask);
+        }
+        ~ScopedSigpipeBlock() {
+            if (brokenPipe && !alreadyPending) {
+                timespec noWait = { 0, 0 };
+                while (sigtimedwait(&pipeSignal, nullptr, &noWait) < 0 && errno == EINTR) {}
+            }
+            pthread_sigmask(SIG_SETMASK, &previousMask, nullptr);
+        }
+
+        bool brokenPipe = false;
+
+    private:
+        sigset_t pipeSignal;
+        sigset_t previousMask;
+        bool alreadyPending;
+    };
+#endif
+}
+
+/**
+ * @brief  Asks the engine to quit, closes the pipes and reaps the child.
+ *
+ * An engine that ignores "quit" is killed after a short grace period so the
+ * destructor never hangs and never leaves a zombie behind.
+ */
+Stockfish::~Stockfish() {
+    if (running) sendCommand("quit");
+    closeFd(childStdin);
+    closeFd(childStdout);
+    if (childPid <= 0) return;
+
+    auto deadline = std::chrono::steady_clock::now() + QUIT_GRACE_PERIOD;
+    while (waitpid(childPid, nullptr, WNOHANG) == 0) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            kill(childPid, SIGKILL);
+            waitpid(childPid, nullptr, 0);
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+}
+
+/**
+ * @brief  Spawns the engine with its stdin and stdout connected to pipes.
+ *
+ * stderr shares the stdout pipe, as on Windows. `stockfishPath` is looked up
+ * in PATH when it contains no slash.
+ */
+void Stockfish::startStockfish() {
+    std::unique_lock<std::mutex> spawnLock(spawnMutex, std::defer_lock);
+    if (!HAS_PIPE2) spawnLock.lock();
+
+    // Every pipe end is close-on-exec, so the child keeps only the copies dup2'ed onto 0, 1 and 2
+    int inPipe[2], outPipe[2];
+    if (!openPipe(inPipe)) {
+        std::cerr << "Failed to start Stockfish!" << std::endl;
+        return;
+    }
+    if (!openPipe(outPipe)) {
+        close(inPipe[0]);
+        close(inPipe[1]);
+        std::cerr << "Failed to start Stockfish!" << std::endl;
+        return;
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, inPipe[0], STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, outPipe[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, outPipe[1], STDERR_FILENO);
+
+    char* argv[] = { const_cast<char*>(stockfishPath.c_str()), nullptr };
+    pid_t pid;
+    int error = posix_spawnp(&pid, stockfishPath.c_str(), &actions, nullptr, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(inPipe[0]);
+    close(outPipe[1]);
+    if (spawnLock.owns_lock()) spawnLock.unlock();
+
+    if (error != 0) {
+        close(inPipe[1]);
+        close(outPipe[0]);
+        std::cerr << "Failed to start Stockfish!" << std::endl;
+        return;
+    }
+
+    childPid = pid;
+    childStdin = inPipe[1];
+    childStdout = outPipe[0];
+    fcntl(childStdout, F_SETFL, fcntl(childStdout, F_GETFL) | O_NONBLOCK);
+#if defined(F_SETNOSIGPIPE)
+    // A write to an engine that has died must fail with EPIPE instead of killing the game
+    fcntl(childStdin, F_SETNOSIGPIPE, 1);
+#endif
+    running = true;
+
+    handshake();
+}
+
+/**
+ * @brief  Kills the engine at once and reaps it. Used when it has died or stopped answering.
+ */
+void Stockfish::killStockfish() {
+    running = false;
+    {
+        std::lock_guard<std::mutex> lock(writeMutex);
+        closeFd(childStdin);
+    }
+    closeFd(childStdout);
+    if (childPid <= 0) return;
+
+    kill(childPid, SIGKILL);
+    waitpid(childPid, nullptr, 0);
+    childPid = -1;
+}
+
+void Stockfish::sendCommand(const std::string& command) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (childStdin < 0) return;
+
+    std::string cmd = command + "\n";
+#if !defined(F_SETNOSIGPIPE)
+    ScopedSigpipeBlock sigpipeBlock;
+#endif
+    size_t offset = 0;
+    while (offset < cmd.size()) {
+        ssize_t written = write(childStdin, cmd.data() + offset, cmd.size() - offset);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+#if !defined(F_SETNOSIGPIPE)
+            sigpipeBlock.brokenPipe = errno == EPIPE;
+#endif
+            running = false;  // EPIPE: the engine has exited
+            return;
+        }
+        offset += static_cast<size_t>(written);
+    }
+}
+
+/**
+ * @brief  Waits in poll() up to `timeoutMs` for engine output and appends what arrived to `output`.
+ *
+ * Returns false once the engine has closed its end of the pipe; a timeout
+ * returns true with nothing appended.
+ */
+bool Stockfish::readChunk(std::string& output, int timeoutMs) {
+    char buffer[4096];
+
+    while (childStdout >= 0) {
+        pollfd readable = { childStdout, POLLIN, 0 };
+        int ready = poll(&readable, 1, timeoutMs);
+        if (ready == 0) return true;
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        ssize_t bytesRead = read(childStdout, buffer, sizeof(buffer));
+        if (bytesRead > 0) {
+            output.append(buffer, static_cast<size_t>(bytesRead));
+            return true;
+        }
+        if (bytesRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) continue;
+        break;  // EOF: the engine has exited
+    }
+
+    running = false;
+    return false;
+}
+
+#endif
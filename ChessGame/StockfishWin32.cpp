@@ -0,0 +1,109 @@
+#include "Stockfish.h"
+
+#if defined(_WIN32)
+
+Stockfish::~Stockfish() {
+    if (running) sendCommand("quit");
+    // Give the engine a moment to exit after "quit", then make sure it is gone
+    if (piProcInfo.hProcess && WaitForSingleObject(piProcInfo.hProcess, 500) == WAIT_TIMEOUT) {
+        TerminateProcess(piProcInfo.hProcess, 1);
+    }
+    killStockfish();
+}
+
+/**
+ * @brief  Terminates the engine at once and closes its handles. Used when it has died or stopped answering.
+ */
+void Stockfish::killStockfish() {
+    running = false;
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (piProcInfo.hProcess) {
+        TerminateProcess(piProcInfo.hProcess, 1);
+        WaitForSingleObject(piProcInfo.hProcess, INFINITE);
+        CloseHandle(piProcInfo.hProcess);
+        CloseHandle(piProcInfo.hThread);
+        piProcInfo.hProcess = NULL;
+        piProcInfo.hThread = NULL;
+    }
+    if (hChildStd_IN_Wr) CloseHandle(hChildStd_IN_Wr);
+    if (hChildStd_OUT_Rd) CloseHandle(hChildStd_OUT_Rd);
+    hChildStd_IN_Wr = NULL;
+    hChildStd_OUT_Rd = NULL;
+}
+
+void Stockfish::startStockfish() {
+    SECURITY_ATTRIBUTES saAttr;
+    saAttr.nLength = sizeof(SECURITY_ATTRIBUTES);
+    saAttr.bInheritHandle = TRUE;
+    saAttr.lpSecurityDescriptor = NULL;
+
+    CreatePipe(&hChildStd_OUT_Rd, &hChildStd_OUT_Wr, &saAttr, 0);
+    CreatePipe(&hChildStd_IN_Rd, &hChildStd_IN_Wr, &saAttr, 0);
+
+    ZeroMemory(&piProcInfo, sizeof(PROCESS_INFORMATION));
+    ZeroMemory(&siStartInfo, sizeof(STARTUPINFO));
+    siStartInfo.cb = sizeof(STARTUPINFO);
+    siStartInfo.hStdError = hChildStd_OUT_Wr;
+    siStartInfo.hStdOutput = hChildStd_OUT_Wr;
+    siStartInfo.hStdInput = hChildStd_IN_Rd;
+    siStartInfo.dwFlags |= STARTF_USESTDHANDLES;
+
+    // Convert std::string to std::wstring using MultiByteToWideChar
+    int size_needed = MultiByteToWideChar(CP_UTF8, 0, stockfishPath.c_str(), -1, NULL, 0);
+    std::wstring wStockfishPath(size_needed, 0);
+    MultiByteToWideChar(CP_UTF8, 0, stockfishPath.c_str(), -1, &wStockfishPath[0], size_needed);
+
+    // Use CreateProcessW with wide-character string
+    if (!CreateProcessW(wStockfishPath.c_str(), NULL, NULL, NULL, TRUE, 0, NULL, NULL, &siStartInfo, &piProcInfo)) {
+        std::cerr << "Failed to start Stockfish!" << std::endl;
+        return;
+    }
+    // Drop our copies of the child's ends so a dead engine reads as end-of-file
+    CloseHandle(hChildStd_OUT_Wr);
+    CloseHandle(hChildStd_IN_Rd);
+    hChildStd_OUT_Wr = NULL;
+    hChildStd_IN_Rd = NULL;
+    running = true;
+
+    handshake();
+}
+
+void Stockfish::sendCommand(const std::string& command) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (!hChildStd_IN_Wr) return;
+    std::string cmd = command + "\n";
+    DWORD written;
+    WriteFile(hChildStd_IN_Wr, cmd.c_str(), cmd.length(), &written, NULL);
+}
+
+/**
+ * @brief  Waits up to `timeoutMs` for engine output and appends what arrived to `output`.
+ *
+ * Anonymous pipes cannot be polled, so PeekNamedPipe is checked every
+ * millisecond until data arrives. Returns false once the engine has closed
+ * its end of the pipe; a timeout returns true with nothing appended.
+ */
+bool Stockfish::readChunk(std::string& output, int timeoutMs) {
+    ULONGLONG deadline = GetTickCount64() + timeoutMs;
+    DWORD available = 0;
+    while (true) {
+        if (!PeekNamedPipe(hChildStd_OUT_Rd, NULL, 0, NULL, &available, NULL)) {
+            running = false;
+            return false;
+        }
+        if (available > 0) break;
+        if (GetTickCount64() >= deadline) return true;
+        Sleep(1);
+    }
+
+    DWORD bytesRead = 0;
+    CHAR buffer[4096];
+    if (!ReadFile(hChildStd_OUT_Rd, buffer, available < sizeof(buffer) ? available : sizeof(buffer), &bytesRead, NULL) || bytesRead == 0) {
+        running = false;
+        return false;
+    }
+    output.append(buffer, bytesRead);
+    return true;
+}
+
+#endif
@@ -0,0 +1,128 @@
+#include "TranspositionTable.h"
+
+TranspositionTable::TranspositionTable(size_t megabytes) : bucketCount(0), generation(0) {
+	resize(megabytes);
+}
+
+/**
+ * @brief  Reallocates the table, rounding down to a power-of-two bucket count.
+ *
+ * Not safe while a search is running.
+ */
+void TranspositionTable::resize(size_t megabytes) {
+	size_t bytes = (megabytes ? megabytes : 1) * 1024 * 1024;
+	size_t count = 1;
+	while (count * 2 * sizeof(Bucket) <= bytes) count *= 2;
+
+	if (count != bucketCount) {
+		buckets.reset(new Bucket[count]);
+		bucketCount = count;
+	}
+	clear();
+}
+
+void TranspositionTable::clear() {
+	for (size_t i = 0; i < bucketCount; ++i) {
+		for (Entry& entry : buckets[i].entries) {
+			entry.keyXorData.store(0, std::memory_order_relaxed);
+			entry.data.store(0, std::memory_order_relaxed);
+		}
+	}
+	generation = 0;
+}
+
+/**
+ * @brief  Layout: move in bits 0-15, score 32-47, depth 48-55, bound 56-57, age 58-63.
+ */
+uint64_t TranspositionTable::pack(Move move, int score, int depth, Bound bound, uint8_t age) {
+	return static_cast<uint64_t>(move.raw())
+		| (static_cast<uint64_t>(static_cast<uint16_t>(score)) << 32)
+		| (static_cast<uint64_t>(static_cast<uint8_t>(depth)) << 48)
+		| (static_cast<uint64_t>(bound) << 56)
+		| (static_cast<uint64_t>(age) << 58);
+}
+
+TTData TranspositionTable::unpack(uint64_t data) {
+	TTData result;
+	result.move = Move::fromRaw(static_cast<uint16_t>(data));
+	result.score = static_cast<int16_t>(data >> 32);
+	result.depth = depthOf(data);
+	result.bound = static_cast<Bound>((data >> 56) & 3);
+	return result;
+}
+
+/**
+ * @brief  Looks up a position. Returns false on a miss or a torn entry.
+ */
+bool TranspositionTable::probe(uint64_t key, TTData& data, TTStats& stats) const {
+	const Bucket& bucket = bucketFor(key);
+	for (const Entry& entry : bucket.entries) {
+		uint64_t entryData = entry.data.load(std::memory_order_relaxed);
+		uint64_t keyXorData = entry.keyXorData.load(std::memory_order_relaxed);
+		if ((keyXorData ^ entryData) == key && ((entryData >> 56) & 3) != static_cast<uint64_t>(Bound::NONE)) {
+			data = unpack(entryData);
+			++stats.hits;
+			return true;
+		}
+	}
+	++stats.misses;
+	return false;
+}
+
+/**
+ * @brief  Stores a search result.
+ *
+ * An entry for the same position is reused; otherwise the entry that is the
+ * least valuable to keep is evicted, where older generations and shallower
+ * depths count as less valuable.
+ */
+void TranspositionTable::store(uint64_t key, Move move, int score, int depth, Bound bound, TTStats& stats) {
+	Bucket& bucket = bucketFor(key);
+	Entry* replace = nullptr;
+	int worstValue = 0;
+
+	for (Entry& entry : bucket.entries) {
+		uint64_t entryData = entry.data.load(std::memory_order_relaxed);
+		uint64_t keyXorData = entry.keyXorData.load(std::memory_order_relaxed);
+
+		if ((keyXorData ^ entryData) == key) {
+			// Keep a deeper result for the same position unless it is from an old search or we have an exact score
+			if (bound != Bound::EXACT && ageOf(entryData) == generation && depthOf(entryData) > depth + 2) return;
+			// Keep the known best move if this search did not find one
+			if (move == NO_MOVE) move = unpack(entryData).move;
+			replace = &entry;
+			++stats.replacements;
+			break;
+		}
+
+		int age = (generation - ageOf(entryData)) & AGE_MASK;
+		int value = depthOf(entryData) - 8 * age;
+		if (!replace || value < worstValue) {
+			replace = &entry;
+			worstValue = value;
+		}
+	}
+
+	uint64_t oldData = replace->data.load(std::memory_order_relaxed);
+	uint64_t oldKey = replace->keyXorData.load(std::memory_order_relaxed) ^ oldData;
+	if (oldKey != key && ((oldData >> 56) & 3) != static_cast<uint64_t>(Bound::NONE)) ++stats.collisions;
+
+	uint64_t newData = pack(move, score, depth, bound, generation);
+	replace->keyXorData.store(key ^ newData, std::memory_order_relaxed);
+	replace->data.store(newData, std::memory_order_relaxed);
+}
+
+/**
+ * @brief  Permille of sampled entries written during the current search, as reported by UCI engines.
+ */
+int TranspositionTable::hashfull() const {
+	int used = 0;
+	size_t sampleBuckets = bucketCount < 250 ? bucketCount : 250;
+	for (size_t i = 0; i < sampleBuckets; ++i) {
+		for (const Entry& entry : buckets[i].entries) {
+			uint64_t entryData = entry.data.load(std::memory_order_relaxed);
+			if (((entryData >> 56) & 3) != static_cast<uint64_t>(Bound::NONE) && ageOf(entryData) == generation) ++used;
+		}
+	}
+	return static_cast<int>(used * 1000 / (sampleBuckets * ENTRIES_PER_BUCKET));
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "Position.h"
+
+enum class Bound : uint8_t {
+	NONE,
+	UPPER,  // Fail-low: the true score is at most this
+	LOWER,  // Fail-high: the true score is at least this
+	EXACT
+};
+
+struct TTData {
+	Move move;
+	int score;
+	int depth;
+	Bound bound;
+};
+
+/**
+ * @brief  Per-caller counters, so search threads never contend on a shared cache line.
+ */
+struct TTStats {
+	uint64_t hits = 0;          // Probe found the position
+	uint64_t misses = 0;        // Probe found nothing
+	uint64_t collisions = 0;    // Store evicted a different position
+	uint64_t replacements = 0;  // Store overwrote an older result for the same position
+
+	TTStats& operator+=(const TTStats& other) {
+		hits += other.hits;
+		misses += other.misses;
+		collisions += other.collisions;
+		replacements += other.replacements;
+		return *this;
+	}
+};
+
+/**
+ * @brief  Fixed-size hash table of search results shared by all search threads.
+ *
+ * The table is allocated once in cache-line sized buckets of four entries.
+ * Each entry stores `key ^ data` next to `data` in two relaxed atomics
+ * (Hyatt's lockless hashing): a torn write from a concurrent store makes the
+ * XOR check fail, so it reads as a miss instead of returning another
+ * position's data. No locks are taken on probe or store.
+ */
+class TranspositionTable {
+public:
+	explicit TranspositionTable(size_t megabytes = 16);
+
+	void resize(size_t megabytes);
+	void clear();
+	void newSearch() {
+		generation = (generation + 1) & AGE_MASK;
+	}
+
+	bool probe(uint64_t key, TTData& data, TTStats& stats) const;
+	void store(uint64_t key, Move move, int score, int depth, Bound bound, TTStats& stats);
+	int hashfull() const;
+
+	size_t getSizeMB() const {
+		return bucketCount * sizeof(Bucket) / (1024 * 1024);
+	}
+
+private:
+	static constexpr int ENTRIES_PER_BUCKET = 4;
+	static constexpr uint8_t AGE_MASK = 0x3F;
+
+	struct Entry {
+		std::atomic<uint64_t> keyXorData;
+		std::atomic<uint64_t> data;
+	};
+
+	struct alignas(64) Bucket {
+		Entry entries[ENTRIES_PER_BUCKET];
+	};
+
+	Bucket& bucketFor(uint64_t key) const {
+		return buckets[key & (bucketCount - 1)];
+	}
+
+	static uint64_t pack(Move move, int score, int depth, Bound bound, uint8_t age);
+	static TTData unpack(uint64_t data);
+	static uint8_t ageOf(uint64_t data) {
+		return static_cast<uint8_t>(data >> 58);
+	}
+	static int depthOf(uint64_t data) {
+		return static_cast<uint8_t>(data >> 48);
+	}
+
+	std::unique_ptr<Bucket[]> buckets;
+	size_t bucketCount;
+	uint8_t generation;
+};
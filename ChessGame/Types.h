@@ -0,0 +1,41 @@
+#pragma once
+
+enum class PieceType {
+	W_KING = 'K',
+	W_QUEEN = 'Q',
+	W_ROOK = 'R',
+	W_BISHOP = 'B',
+	W_KNIGHT = 'N',
+	W_PAWN = 'P',
+	B_KING = 'k',
+	B_QUEEN = 'q',
+	B_ROOK = 'r',
+	B_BISHOP = 'b',
+	B_KNIGHT = 'n',
+	B_PAWN = 'p',
+	NONE = '.'
+};
+
+enum class Color {
+	WHITE,
+	BLACK
+};
+
+struct Square {
+	int row;
+	int col;
+
+	bool operator==(const Square& other) const {
+		return row == other.row && col == other.col;
+	}
+	bool operator!=(const Square& other) const {
+		return row != other.row || col != other.col;
+	}
+	Square operator+(const Square& other) const {
+		return { row + other.row, col + other.col };
+	}
+	Square& operator+=(const Square& other) {
+		*this = *this + other;
+		return *this;
+	}
+};
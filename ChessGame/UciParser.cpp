@@ -0,0 +1,93 @@
+#include "UciParser.h"
+
+#include <charconv>
+
+namespace {
+	/**
+	 * @brief  Returns the next space-separated token and advances `rest` past it.
+	 */
+	std::string_view nextToken(std::string_view& rest) {
+		size_t start = rest.find_first_not_of(' ');
+		if (start == std::string_view::npos) {
+			rest = {};
+			return {};
+		}
+		size_t end = rest.find(' ', start);
+		if (end == std::string_view::npos) end = rest.size();
+		std::string_view token = rest.substr(start, end - start);
+		rest.remove_prefix(end);
+		return token;
+	}
+
+	template <typename T>
+	void parseNumber(std::string_view& rest, T& value) {
+		std::string_view token = nextToken(rest);
+		std::from_chars(token.data(), token.data() + token.size(), value);
+	}
+
+	std::string_view trimmed(std::string_view text) {
+		size_t start = text.find_first_not_of(' ');
+		if (start == std::string_view::npos) return {};
+		size_t end = text.find_last_not_of(' ');
+		return text.substr(start, end - start + 1);
+	}
+}
+
+namespace Uci {
+	bool startsWith(std::string_view line, std::string_view token) {
+		return line.substr(0, token.size()) == token
+			&& (line.size() == token.size() || line[token.size()] == ' ');
+	}
+
+	/**
+	 * @brief  Parses an "info" line into `info`, resetting it first.
+	 *
+	 * Returns false for any other line. Unknown keys such as currmove or
+	 * string are skipped; "string" and "pv" consume the rest of the line.
+	 */
+	bool parseInfo(std::string_view line, Info& info) {
+		if (!startsWith(line, "info")) return false;
+
+		info = Info();
+		std::string_view rest = line.substr(4);
+		for (std::string_view key = nextToken(rest); !key.empty(); key = nextToken(rest)) {
+			if (key == "depth") parseNumber(rest, info.depth);
+			else if (key == "seldepth") parseNumber(rest, info.seldepth);
+			else if (key == "multipv") parseNumber(rest, info.multipv);
+			else if (key == "nodes") parseNumber(rest, info.nodes);
+			else if (key == "nps") parseNumber(rest, info.nps);
+			else if (key == "time") parseNumber(rest, info.timeMs);
+			else if (key == "hashfull") parseNumber(rest, info.hashfull);
+			else if (key == "lowerbound") info.lowerBound = true;
+			else if (key == "upperbound") info.upperBound = true;
+			else if (key == "score") {
+				std::string_view kind = nextToken(rest);
+				info.isMate = kind == "mate";
+				info.hasScore = true;
+				parseNumber(rest, info.score);
+			}
+			else if (key == "pv") {
+				info.pv = trimmed(rest);
+				std::string_view moves = info.pv;
+				info.bestMove = nextToken(moves);
+				break;
+			}
+			else if (key == "string") {
+				break;
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * @brief  Parses "bestmove <move> [ponder <move>]". `ponder` is empty when absent.
+	 */
+	bool parseBestMove(std::string_view line, std::string_view& move, std::string_view& ponder) {
+		if (!startsWith(line, "bestmove")) return false;
+
+		std::string_view rest = line.substr(8);
+		move = nextToken(rest);
+		ponder = nextToken(rest) == "ponder" ? nextToken(rest) : std::string_view();
+		return true;
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief  Allocation-free parsing of UCI engine output, one line at a time.
+ */
+namespace Uci {
+	/**
+	 * @brief  Fields of an "info" line. Missing fields keep their defaults.
+	 *
+	 * `pv` and `bestMove` point into the parsed line and are only valid while
+	 * that line is.
+	 */
+	struct Info {
+		int depth = 0;
+		int seldepth = 0;
+		int multipv = 1;
+		int score = 0;            // Centipawns, or moves to mate when isMate
+		bool isMate = false;
+		bool lowerBound = false;
+		bool upperBound = false;
+		bool hasScore = false;
+		uint64_t nodes = 0;
+		uint64_t nps = 0;
+		int64_t timeMs = 0;
+		int hashfull = 0;
+		std::string_view pv;        // The whole principal variation
+		std::string_view bestMove;  // First move of pv
+	};
+
+	bool parseInfo(std::string_view line, Info& info);
+	bool parseBestMove(std::string_view line, std::string_view& move, std::string_view& ponder);
+	bool startsWith(std::string_view line, std::string_view token);
+}
@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "AnalysisCache.h"
+#include "EnginePool.h"
+#include "Position.h"
+
+/**
+ * @brief  Batch analysis of FENs with a pool of UCI engines.
+ *
+ * Reads one FEN per line from FILE (or stdin), analyses them all in
+ * parallel and prints, in input order, the best move, score, depth and time
+ * of each. Blank lines and lines starting with '#' are skipped. A summary
+ * with the throughput goes to stderr.
+ *
+ * With --cache, depth-limited results are kept in an AnalysisCache file and
+ * positions already analysed at least as deeply are not sent to an engine.
+ * --timeout caps how long a job without --movetime may run before its
+ * engine is stopped (default ten minutes, 0 for no cap).
+ *
+ *   analyze [--engine PATH] [--engines N] [--threads N] [--hash MB] [--cache FILE]
+ *           [--depth N] [--movetime MS] [--nodes N] [--multipv N] [--timeout MS] [FILE]
+ */
+int main(int argc, char* argv[]) {
+	EngineOptions options;
+	options.path = "stockfish";
+	int engineCount = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+	AnalysisJob jobTemplate;
+	std::string inputPath;
+	std::string cachePath;
+	int64_t timeoutMs = -1;  // Negative keeps the pool's default
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--engine" && i + 1 < argc) {
+			options.path = argv[++i];
+		}
+		else if (arg == "--engines" && i + 1 < argc) {
+			engineCount = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (arg == "--threads" && i + 1 < argc) {
+			options.threads = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (arg == "--hash" && i + 1 < argc) {
+			options.hashMB = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (arg == "--cache" && i + 1 < argc) {
+			cachePath = argv[++i];
+		}
+		else if (arg == "--depth" && i + 1 < argc) {
+			jobTemplate.limits.depth = std::atoi(argv[++i]);
+		}
+		else if (arg == "--movetime" && i + 1 < argc) {
+			jobTemplate.limits.moveTimeMs = std::atoll(argv[++i]);
+		}
+		else if (arg == "--nodes" && i + 1 < argc) {
+			jobTemplate.limits.nodes = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (arg == "--multipv" && i + 1 < argc) {
+			jobTemplate.multiPV = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (arg == "--timeout" && i + 1 < argc) {
+			timeoutMs = std::max<int64_t>(0, std::atoll(argv[++i]));
+		}
+		else if (arg[0] != '-' && inputPath.empty()) {
+			inputPath = arg;
+		}
+		else {
+			std::cerr << "Usage: analyze [--engine PATH] [--engines N] [--threads N] [--hash MB] [--cache FILE]\n"
+				<< "               [--depth N] [--movetime MS] [--nodes N] [--multipv N] [--timeout MS] [FILE]" << std::endl;
+			return 2;
+		}
+	}
+
+	std::ifstream file;
+	if (!inputPath.empty()) {
+		file.open(inputPath);
+		if (!file) {
+			std::cerr << "Cannot open " << inputPath << std::endl;
+			return 2;
+		}
+	}
+	std::istream& input = inputPath.empty() ? std::cin : file;
+
+	std::vector<AnalysisJob> jobs;
+	for (std::string line; std::getline(input, line);) {
+		if (!line.empty() && line.back() == '\r') line.pop_back();
+		if (line.empty() || line[0] == '#') continue;
+		jobs.push_back(jobTemplate);
+		jobs.back().fen = line;
+	}
+
+	// Only a pure depth limit says how good a cached result is
+	const UciLimits& limits = jobTemplate.limits;
+	bool useCache = !cachePath.empty() && limits.depth > 0 && !limits.moveTimeMs && !limits.nodes;
+	if (!cachePath.empty() && !useCache) std::cerr << "--cache needs --depth without --movetime or --nodes; ignoring it" << std::endl;
+	if (useCache && jobTemplate.multiPV > AnalysisCache::MAX_LINES) {
+		std::cerr << "--cache keeps at most " << AnalysisCache::MAX_LINES << " lines per position; ignoring it" << std::endl;
+		useCache = false;
+	}
+
+	AnalysisCache cache;
+	if (useCache && !cache.open(cachePath)) {
+		std::cerr << "Cannot open cache " << cachePath << std::endl;
+		return 2;
+	}
+
+	// Keys of every job, and the indices of the ones the cache cannot answer
+	std::vector<uint64_t> keys(jobs.size());
+	std::vector<AnalysisResult> results(jobs.size());
+	std::vector<size_t> pending;
+	for (size_t i = 0; i < jobs.size(); ++i) {
+		Position position;
+		if (useCache && position.setFromFEN(jobs[i].fen)) {
+			keys[i] = position.getKey();
+			if (cache.lookup(keys[i], jobs[i].multiPV, limits.depth, results[i].analysis)) continue;
+		}
+		pending.push_back(i);
+	}
+
+	// No engine is started when the cache answers everything
+	std::unique_ptr<EnginePool> pool;
+	if (!pending.empty()) {
+		pool = std::make_unique<EnginePool>(options, engineCount);
+		if (timeoutMs >= 0) pool->setJobTimeout(timeoutMs);
+		if (pool->runningCount() == 0) {
+			std::cerr << "Could not start " << options.path << std::endl;
+			return 1;
+		}
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<AnalysisJob> pendingJobs;
+	for (size_t i : pending) pendingJobs.push_back(jobs[i]);
+	std::vector<AnalysisResult> pendingResults = pool ? pool->analyzeBatch(pendingJobs) : std::vector<AnalysisResult>();
+	for (size_t j = 0; j < pending.size(); ++j) {
+		size_t i = pending[j];
+		results[i] = pendingResults[j];
+		if (useCache && keys[i]) cache.store(keys[i], jobs[i].multiPV, results[i].analysis);
+	}
+	auto wallMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+
+	int failed = 0;
+	int64_t jobMs = 0;
+	std::vector<int> jobsPerEngine(pool ? pool->size() : 0);
+	for (size_t i = 0; i < results.size(); ++i) {
+		const AnalysisResult& result = results[i];
+		jobMs += result.timeMs;
+		if (result.engine >= 0) ++jobsPerEngine[result.engine];
+		if (!result.analysis.completed || result.analysis.lines.empty()) {
+			++failed;
+			std::cout << jobs[i].fen << "\tfailed\n";
+			continue;
+		}
+		const UciLine& best = result.analysis.lines[0];
+		std::cout << jobs[i].fen << "\t" << best.move << "\t" << (best.isMate ? "mate " : "cp ") << best.score
+			<< "\tdepth " << result.analysis.depth << "\t" << result.timeMs << " ms\n";
+	}
+
+	if (useCache) std::cerr << jobs.size() - pending.size() << " positions from the cache, ";
+	std::cerr << pending.size() << " positions on " << (pool ? pool->runningCount() : 0) << " engines in " << wallMs << " ms ("
+		<< (wallMs > 0 ? pending.size() * 1000.0 / wallMs : 0.0) << " positions/s, " << jobMs << " ms of engine time)";
+	if (failed) std::cerr << ", " << failed << " failed";
+	std::cerr << "\n  jobs per engine:";
+	for (int count : jobsPerEngine) std::cerr << " " << count;
+	std::cerr << std::endl;
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,115 @@
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Perft.h"
+#include "Search.h"
+
+namespace {
+	double percent(uint64_t part, uint64_t whole) {
+		return whole ? part * 100.0 / whole : 0.0;
+	}
+}
+
+/**
+ * @brief  Headless engine benchmark.
+ *
+ * Searches every perft reference position (or one given FEN) to a fixed
+ * depth and reports the depth reached, nodes and nodes per second, so engine
+ * throughput can be compared between releases. The share of beta cutoffs
+ * made by the first move searched shows how good the move ordering is.
+ * With --clock every position is searched as if both sides had MS left
+ * (plus --inc per move), to check the time each move is given.
+ *
+ *   bench [--fen "<FEN>"] [--depth N] [--movetime MS] [--clock MS [--inc MS]] [--hash MB] [--threads N]
+ */
+int main(int argc, char* argv[]) {
+	SearchLimits limits;
+	limits.depth = 8;
+	std::string fen;
+	size_t hashMB = 16;
+	int threads = 1;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--fen" && i + 1 < argc) {
+			fen = argv[++i];
+		}
+		else if (arg == "--depth" && i + 1 < argc) {
+			limits.depth = std::atoi(argv[++i]);
+		}
+		else if (arg == "--hash" && i + 1 < argc) {
+			hashMB = static_cast<size_t>(std::atoll(argv[++i]));
+		}
+		else if (arg == "--threads" && i + 1 < argc) {
+			threads = std::atoi(argv[++i]);
+		}
+		else if (arg == "--movetime" && i + 1 < argc) {
+			limits.moveTimeMs = std::atoll(argv[++i]);
+			limits.depth = MAX_PLY - 1;
+		}
+		else if (arg == "--clock" && i + 1 < argc) {
+			limits.whiteTimeMs = limits.blackTimeMs = std::atoll(argv[++i]);
+			limits.depth = MAX_PLY - 1;
+		}
+		else if (arg == "--inc" && i + 1 < argc) {
+			limits.whiteIncrementMs = limits.blackIncrementMs = std::atoll(argv[++i]);
+		}
+		else {
+			std::cerr << "Usage: bench [--fen \"<FEN>\"] [--depth N] [--movetime MS] [--clock MS [--inc MS]] [--hash MB] [--threads N]" << std::endl;
+			return 2;
+		}
+	}
+
+	Search search;
+	search.setLimits(limits);
+	search.setHashSize(hashMB);
+	search.setThreads(threads);
+	uint64_t totalNodes = 0;
+	uint64_t totalCutoffs = 0;
+	uint64_t totalFirstMoveCutoffs = 0;
+	int64_t totalMs = 0;
+
+	std::vector<std::pair<std::string, std::string>> positions;
+	if (!fen.empty()) {
+		positions.push_back({ "fen", fen });
+	}
+	else {
+		for (const Perft::ReferencePosition& reference : Perft::REFERENCE_POSITIONS) positions.push_back({ reference.name, reference.fen });
+	}
+
+	for (const auto& [name, positionFen] : positions) {
+		Position position;
+		if (!position.setFromFEN(positionFen)) {
+			std::cerr << "Invalid FEN: " << positionFen << std::endl;
+			return 2;
+		}
+		search.clearHash();
+		SearchResult result = search.think(position);
+
+		totalNodes += result.nodes;
+		totalCutoffs += result.betaCutoffs;
+		totalFirstMoveCutoffs += result.firstMoveCutoffs;
+		totalMs += result.timeMs;
+		std::cout << name << ": depth " << result.depth
+			<< " bestmove " << (result.bestMoves.empty() ? "(none)" : Position::moveToUci(result.bestMoves[0]))
+			<< " score " << (result.scores.empty() ? 0 : result.scores[0])
+			<< " nodes " << result.nodes << " time " << result.timeMs << " ms nps " << result.nps << "\n"
+			<< "  tt hits " << result.ttStats.hits << " misses " << result.ttStats.misses
+			<< " collisions " << result.ttStats.collisions << " replacements " << result.ttStats.replacements
+			<< " hashfull " << result.hashfull << "\n"
+			<< "  beta cutoffs " << result.betaCutoffs << ", " << percent(result.firstMoveCutoffs, result.betaCutoffs) << "% on the first move\n";
+		if (result.threadNodes.size() > 1) {
+			std::cout << "  thread nodes";
+			for (uint64_t threadNodes : result.threadNodes) std::cout << " " << threadNodes;
+			std::cout << "\n";
+		}
+	}
+
+	std::cout << "total: " << totalNodes << " nodes in " << totalMs << " ms, "
+		<< (totalMs > 0 ? totalNodes * 1000 / totalMs : totalNodes) << " nps, "
+		<< percent(totalFirstMoveCutoffs, totalCutoffs) << "% of cutoffs on the first move" << std::endl;
+	return 0;
+}
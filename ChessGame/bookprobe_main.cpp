@@ -0,0 +1,78 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "PolyglotBook.h"
+
+/**
+ * @brief  Probes a Polyglot book for one position and times the probe.
+ *
+ *   bookprobe --book FILE --random FILE [--fen "<FEN>"] [--iterations N]
+ *
+ * --random names the text file holding the 781 Polyglot Random64 numbers.
+ * It is rejected unless the start position hashes to 463b96181691fc9c, the
+ * key the Polyglot specification gives for it.
+ */
+int main(int argc, char* argv[]) {
+	std::string bookPath, randomPath;
+	std::string fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+	int iterations = 100000;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--book" && i + 1 < argc) {
+			bookPath = argv[++i];
+		}
+		else if (arg == "--random" && i + 1 < argc) {
+			randomPath = argv[++i];
+		}
+		else if (arg == "--fen" && i + 1 < argc) {
+			fen = argv[++i];
+		}
+		else if (arg == "--iterations" && i + 1 < argc) {
+			iterations = std::max(1, std::atoi(argv[++i]));
+		}
+		else {
+			std::cerr << "Usage: bookprobe --book FILE --random FILE [--fen \"<FEN>\"] [--iterations N]" << std::endl;
+			return 2;
+		}
+	}
+
+	if (!PolyglotBook::loadRandomTable(randomPath)) {
+		std::cerr << "Cannot read the Polyglot Random64 table from " << randomPath << ": it needs 781 numbers, and the start position must hash to "
+			<< std::hex << PolyglotBook::START_POSITION_KEY << std::dec << std::endl;
+		return 2;
+	}
+	auto openStart = std::chrono::steady_clock::now();
+	PolyglotBook book;
+	if (!book.open(bookPath)) {
+		std::cerr << "Cannot open book " << bookPath << std::endl;
+		return 2;
+	}
+	auto openUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - openStart).count();
+
+	Position position;
+	if (!position.setFromFEN(fen)) {
+		std::cerr << "Invalid FEN: " << fen << std::endl;
+		return 2;
+	}
+
+	std::cout << book.size() << " entries, opened in " << openUs << " us\n"
+		<< "key " << std::hex << PolyglotBook::polyglotKey(position) << std::dec
+		<< ", " << book.countMoves(position) << " book moves\n";
+
+	Move move = NO_MOVE;
+	int found = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; ++i) {
+		move = book.probe(position);
+		found += move != NO_MOVE;
+	}
+	auto elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << "probe: " << (move == NO_MOVE ? "(none)" : Position::moveToUci(move)) << ", " << found << "/" << iterations
+		<< " hits, " << elapsedNs / iterations << " ns per probe" << std::endl;
+	return 0;
+}
@@ -0,0 +1,89 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Perft.h"
+#include "Position.h"
+
+namespace {
+	template <typename Evaluate>
+	double evalsPerSecond(const std::vector<Position>& positions, int rounds, Evaluate evaluate, int64_t& checksum) {
+		checksum = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int round = 0; round < rounds; ++round) {
+			for (const Position& position : positions) checksum += evaluate(position);
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return seconds > 0 ? positions.size() * static_cast<double>(rounds) / seconds : 0.0;
+	}
+}
+
+/**
+ * @brief  Evaluation benchmark.
+ *
+ * Gathers the positions of the perft reference trees (or of one FEN) down
+ * to a small depth, then evaluates all of them repeatedly, once with the
+ * incrementally kept sums and once rescanning the board, and reports
+ * evaluations per second for both. The two must agree on every position.
+ *
+ *   evalbench [--fen "<FEN>"] [--depth N] [--rounds N]
+ */
+int main(int argc, char* argv[]) {
+	std::string fen;
+	int depth = 3;
+	int rounds = 20;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--fen" && i + 1 < argc) {
+			fen = argv[++i];
+		}
+		else if (arg == "--depth" && i + 1 < argc) {
+			depth = std::max(0, std::atoi(argv[++i]));
+		}
+		else if (arg == "--rounds" && i + 1 < argc) {
+			rounds = std::max(1, std::atoi(argv[++i]));
+		}
+		else {
+			std::cerr << "Usage: evalbench [--fen \"<FEN>\"] [--depth N] [--rounds N]" << std::endl;
+			return 2;
+		}
+	}
+
+	std::vector<std::string> fens;
+	if (!fen.empty()) {
+		fens.push_back(fen);
+	}
+	else {
+		for (const Perft::ReferencePosition& reference : Perft::REFERENCE_POSITIONS) fens.push_back(reference.fen);
+	}
+
+	std::vector<Position> positions;
+	for (const std::string& rootFen : fens) {
+		Position position;
+		if (!position.setFromFEN(rootFen)) {
+			std::cerr << "Invalid FEN: " << rootFen << std::endl;
+			return 2;
+		}
+		Perft::collectPositions(position, depth, positions);
+	}
+
+	for (const Position& position : positions) {
+		if (position.evaluate() != position.evaluateFromScratch()) {
+			std::cerr << "Incremental evaluation " << position.evaluate() << " differs from " << position.evaluateFromScratch() << std::endl;
+			return 1;
+		}
+	}
+
+	int64_t incrementalSum, scanSum;
+	double incremental = evalsPerSecond(positions, rounds, [](const Position& position) { return position.evaluate(); }, incrementalSum);
+	double scan = evalsPerSecond(positions, rounds, [](const Position& position) { return position.evaluateFromScratch(); }, scanSum);
+
+	std::cout << positions.size() << " positions, " << rounds << " rounds (checksums " << incrementalSum << ", " << scanSum << ")\n"
+		<< "incremental: " << incremental << " evals/s\n"
+		<< "full scan:   " << scan << " evals/s" << std::endl;
+	return 0;
+}
@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ChessBoard.h"
+#include "Perft.h"
+
+/**
+ * @brief  FEN parsing and writing benchmark.
+ *
+ * Loads every FEN from FILE (one per line, or the perft reference positions
+ * without one) into a ChessBoard and writes it back into a fixed buffer,
+ * repeatedly, and reports positions per second for each direction. FENs that
+ * fail validation or do not come back unchanged are listed first.
+ *
+ *   fenbench [--iterations N] [FILE]
+ */
+int main(int argc, char* argv[]) {
+	int iterations = 200000;
+	std::string inputPath;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--iterations" && i + 1 < argc) {
+			iterations = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (arg[0] != '-' && inputPath.empty()) {
+			inputPath = arg;
+		}
+		else {
+			std::cerr << "Usage: fenbench [--iterations N] [FILE]" << std::endl;
+			return 2;
+		}
+	}
+
+	std::vector<std::string> fens;
+	if (!inputPath.empty()) {
+		std::ifstream file(inputPath);
+		if (!file) {
+			std::cerr << "Cannot open " << inputPath << std::endl;
+			return 2;
+		}
+		for (std::string line; std::getline(file, line);) {
+			if (!line.empty() && line.back() == '\r') line.pop_back();
+			if (!line.empty() && line[0] != '#') fens.push_back(line);
+		}
+	}
+	else {
+		for (const Perft::ReferencePosition& reference : Perft::REFERENCE_POSITIONS) fens.push_back(reference.fen);
+	}
+
+	ChessBoard board;
+	char buffer[FEN_BUFFER_SIZE];
+	std::vector<std::string> validFens;
+	for (const std::string& fen : fens) {
+		if (!board.loadFEN(fen)) {
+			std::cout << "invalid: " << fen << "\n";
+			continue;
+		}
+		validFens.push_back(fen);
+		board.writeFEN(buffer);
+		if (fen != buffer) std::cout << "rewritten: " << fen << " -> " << buffer << "\n";
+	}
+	if (validFens.empty()) {
+		std::cerr << "No valid FEN to benchmark" << std::endl;
+		return 1;
+	}
+
+	// Parse every FEN, then write the last one loaded many times over
+	int loaded = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; ++i) {
+		loaded += board.loadFEN(validFens[i % validFens.size()]);
+	}
+	double parseSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	size_t written = 0;
+	start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; ++i) {
+		written += board.writeFEN(buffer);
+	}
+	double writeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << validFens.size() << " of " << fens.size() << " FENs valid\n"
+		<< "loadFEN:  " << loaded << " positions in " << parseSeconds * 1000 << " ms, "
+		<< (parseSeconds > 0 ? loaded / parseSeconds : 0.0) << " positions/s\n"
+		<< "writeFEN: " << iterations << " positions in " << writeSeconds * 1000 << " ms, "
+		<< (writeSeconds > 0 ? iterations / writeSeconds : 0.0) << " positions/s (" << written << " chars)" << std::endl;
+	return validFens.size() == fens.size() ? 0 : 1;
+}
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Nnue.h"
+#include "Perft.h"
+#include "Position.h"
+#include "SearchWorker.h"
+
+namespace {
+	// Accumulators are 1 KB each, so the evaluate-only pass samples at most this many positions
+	constexpr size_t MAX_SAMPLE = 1 << 18;
+
+	// Writes a network with small pseudo-random weights, the same on every run
+	bool writeRandomNetwork(const std::string& path) {
+		std::vector<int16_t> weights((Nnue::FILE_SIZE - sizeof(Nnue::FileHeader) - sizeof(int32_t)) / sizeof(int16_t));
+		uint64_t state = 0x9E3779B97F4A7C15ULL;
+		for (int16_t& weight : weights) {
+			state ^= state << 13;
+			state ^= state >> 7;
+			state ^= state << 17;
+			weight = static_cast<int16_t>(static_cast<int>(state % 65) - 32);
+		}
+		Nnue::FileHeader header = {};
+		std::memcpy(header.magic, "CGNNUE01", sizeof(header.magic));
+		header.hidden = Nnue::HIDDEN;
+		int32_t outputBias = 0;
+
+		std::ofstream file(path, std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(reinterpret_cast<const char*>(weights.data()), weights.size() * sizeof(int16_t));
+		file.write(reinterpret_cast<const char*>(&outputBias), sizeof(outputBias));
+		return static_cast<bool>(file);
+	}
+
+	/*
+	 * Walks the tree the way the search does: each child accumulator is the
+	 * parent's updated for the move, then evaluated. With `verify` every
+	 * node is also refreshed from scratch and compared. Returns the number
+	 * of nodes, or -1 on a mismatch.
+	 */
+	int64_t walk(Position& position, Nnue::Accumulator* stack, int depth, int64_t& checksum, bool verify) {
+		checksum += Nnue::evaluate(stack[0], static_cast<int>(position.sideToMove()));
+		if (verify) {
+			Nnue::Accumulator fresh;
+			Nnue::refresh(fresh, position);
+			if (std::memcmp(fresh.values, stack[0].values, sizeof(fresh.values)) != 0) return -1;
+		}
+		if (depth == 0) return 1;
+
+		int64_t nodes = 1;
+		MoveList moves;
+		position.generateLegalMoves(moves);
+		for (Move move : moves) {
+			Nnue::update(stack[1], stack[0], position, move);
+			UndoInfo undo;
+			position.makeMove(move, undo);
+			int64_t childNodes = walk(position, stack + 1, depth - 1, checksum, verify);
+			position.unmakeMove(move, undo);
+			if (childNodes < 0) return -1;
+			nodes += childNodes;
+		}
+		return nodes;
+	}
+
+	double seconds(std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+}
+
+/**
+ * @brief  NNUE benchmark.
+ *
+ * Loads a network (by default a generated one with random weights, which
+ * is as slow to evaluate as a trained one) and, for every instruction set
+ * the CPU supports, reports evaluations per second on prebuilt
+ * accumulators and nodes per second for a tree walk that updates the
+ * accumulator on each move and evaluates every node. The incremental
+ * accumulators must equal a refresh from scratch and all instruction sets
+ * must give the same scores.
+ *
+ *   nnuebench [--net FILE] [--depth N] [--rounds N]
+ */
+int main(int argc, char* argv[]) {
+	std::string netPath;
+	int depth = 3;
+	int rounds = 20;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--net" && i + 1 < argc) {
+			netPath = argv[++i];
+		}
+		else if (arg == "--depth" && i + 1 < argc) {
+			depth = std::clamp(std::atoi(argv[++i]), 0, MAX_PLY - 1);
+		}
+		else if (arg == "--rounds" && i + 1 < argc) {
+			rounds = std::max(1, std::atoi(argv[++i]));
+		}
+		else {
+			std::cerr << "Usage: nnuebench [--net FILE] [--depth N] [--rounds N]" << std::endl;
+			return 2;
+		}
+	}
+
+	if (netPath.empty()) {
+		netPath = (std::filesystem::temp_directory_path() / "nnuebench_random.nnue").string();
+		if (!writeRandomNetwork(netPath)) {
+			std::cerr << "Cannot write " << netPath << std::endl;
+			return 2;
+		}
+	}
+	if (!Nnue::load(netPath)) {
+		std::cerr << "Cannot load network " << netPath << std::endl;
+		return 2;
+	}
+
+	std::vector<Position> roots;
+	for (const Perft::ReferencePosition& reference : Perft::REFERENCE_POSITIONS) {
+		roots.emplace_back();
+		roots.back().setFromFEN(reference.fen);
+	}
+	std::vector<Position> positions;
+	for (const Position& root : roots) Perft::collectPositions(root, depth, positions, MAX_SAMPLE);
+
+	std::vector<Nnue::Accumulator> accumulators(positions.size());
+	std::vector<int> sideToMove(positions.size());
+	for (size_t i = 0; i < positions.size(); ++i) {
+		Nnue::refresh(accumulators[i], positions[i]);
+		sideToMove[i] = static_cast<int>(positions[i].sideToMove());
+	}
+
+	std::cout << positions.size() << " positions, " << rounds << " rounds, network " << netPath << "\n";
+	int64_t referenceChecksum = 0;
+	for (int level = 0; level <= static_cast<int>(Nnue::detectSimd()); ++level) {
+		Nnue::setSimdLevel(static_cast<Nnue::SimdLevel>(level));
+
+		int64_t evalChecksum = 0;
+		auto start = std::chrono::steady_clock::now();
+		for (int round = 0; round < rounds; ++round) {
+			for (size_t i = 0; i < accumulators.size(); ++i) evalChecksum += Nnue::evaluate(accumulators[i], sideToMove[i]);
+		}
+		double evalSeconds = seconds(start);
+
+		std::vector<Nnue::Accumulator> stack(MAX_PLY + 1);
+		int64_t walkChecksum = 0;
+		for (Position root : roots) {
+			Nnue::refresh(stack[0], root);
+			if (walk(root, stack.data(), depth, walkChecksum, true) < 0) {
+				std::cerr << Nnue::simdName(Nnue::getSimdLevel()) << ": incremental accumulator differs from a refresh" << std::endl;
+				return 1;
+			}
+		}
+
+		int64_t walkNodes = 0;
+		start = std::chrono::steady_clock::now();
+		for (int round = 0; round < rounds; ++round) {
+			for (Position root : roots) {
+				Nnue::refresh(stack[0], root);
+				walkNodes += walk(root, stack.data(), depth, walkChecksum, false);
+			}
+		}
+		double walkSeconds = seconds(start);
+
+		if (level == 0) referenceChecksum = evalChecksum;
+		if (evalChecksum != referenceChecksum) {
+			std::cerr << Nnue::simdName(Nnue::getSimdLevel()) << ": checksum " << evalChecksum << " differs from " << referenceChecksum << std::endl;
+			return 1;
+		}
+		std::cout << Nnue::simdName(Nnue::getSimdLevel()) << ":\tevaluate " << (evalSeconds > 0 ? accumulators.size() * static_cast<double>(rounds) / evalSeconds : 0.0)
+			<< " evals/s, update+evaluate " << (walkSeconds > 0 ? walkNodes / walkSeconds : 0.0) << " nodes/s (checksum " << evalChecksum << ")\n";
+	}
+	std::cout.flush();
+	return 0;
+}
@@ -0,0 +1,56 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "Perft.h"
+
+/**
+ * @brief  Headless perft driver.
+ *
+ *   perft                          run the reference suite and verify node counts
+ *   perft [--fen "<FEN>"] --depth N count nodes for one position (start position by default)
+ *   perft ... --divide             also print the count below each root move
+ */
+int main(int argc, char* argv[]) {
+	std::string fen;
+	int depth = 0;
+	bool divide = false;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--fen" && i + 1 < argc) {
+			fen = argv[++i];
+		}
+		else if (arg == "--depth" && i + 1 < argc) {
+			depth = std::atoi(argv[++i]);
+		}
+		else if (arg == "--divide") {
+			divide = true;
+		}
+		else {
+			std::cerr << "Usage: perft [--fen \"<FEN>\"] [--depth N] [--divide]" << std::endl;
+			return 2;
+		}
+	}
+
+	if (fen.empty() && depth == 0 && !divide) {
+		return Perft::runReferenceSuite(std::cout) ? 0 : 1;
+	}
+
+	Position position;
+	if (!fen.empty() && !position.setFromFEN(fen)) {
+		std::cerr << "Invalid FEN: " << fen << std::endl;
+		return 2;
+	}
+	if (depth < 1) depth = 1;
+
+	auto start = std::chrono::steady_clock::now();
+	uint64_t nodes = divide ? Perft::divide(position, depth, std::cout) : Perft::perft(position, depth);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << "nodes: " << nodes << "\n"
+		<< "time: " << seconds << " s\n"
+		<< "nps: " << static_cast<uint64_t>(nodes / (seconds > 0 ? seconds : 1e-9)) << std::endl;
+	return 0;
+}
@@ -0,0 +1,50 @@
+#!/bin/sh
+# Minimal stand-in for a UCI engine, used to exercise and benchmark the
+# Stockfish bridge without a real engine binary. It answers instantly and
+# always suggests the same legal opening moves, one per MultiPV line.
+# "go ponder" and "go infinite" wait for ponderhit or stop, as a real engine does.
+
+multipv=1
+waiting=0
+
+answer() {
+    i=1
+    for move in e2e4 d2d4 g1f3 c2c4 b1c3; do
+        [ "$i" -gt "$multipv" ] && break
+        echo "info depth 1 seldepth 1 multipv $i score cp 0 nodes 1 pv $move e7e5"
+        i=$((i + 1))
+    done
+    echo "bestmove e2e4 ponder e7e5"
+}
+
+while IFS= read -r line; do
+    case "$line" in
+        uci)
+            echo "id name FakeUCI"
+            echo "id author ChessGame"
+            echo "option name MultiPV type spin default 1 min 1 max 500"
+            echo "uciok"
+            ;;
+        isready)
+            echo "readyok"
+            ;;
+        "setoption name MultiPV value "*)
+            multipv=${line##* }
+            ;;
+        "go ponder"*|"go infinite"*)
+            waiting=1
+            ;;
+        go*)
+            answer
+            ;;
+        ponderhit|stop)
+            if [ "$waiting" -eq 1 ]; then
+                waiting=0
+                answer
+            fi
+            ;;
+        quit)
+            exit 0
+            ;;
+    esac
+done
@@ -0,0 +1,80 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "Stockfish.h"
+
+#if !defined(FAKE_UCI_ENGINE)
+#define FAKE_UCI_ENGINE "tools/fake_uci_engine.sh"
+#endif
+
+/**
+ * @brief  Round-trip latency benchmark for the UCI engine bridge.
+ *
+ * Starts an engine (by default the fake one in tools/, which answers
+ * instantly, so the time measured is the bridge's own overhead) and times
+ * repeated getBestMoves calls on the start position.
+ *
+ *   ucibench [--engine PATH] [--iterations N] [--multipv N]
+ */
+int main(int argc, char* argv[]) {
+	std::string enginePath = FAKE_UCI_ENGINE;
+	int iterations = 1000;
+	int multiPV = 3;
+
+	for (int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if (arg == "--engine" && i + 1 < argc) {
+			enginePath = argv[++i];
+		}
+		else if (arg == "--iterations" && i + 1 < argc) {
+			iterations = std::max(1, std::atoi(argv[++i]));
+		}
+		else if (arg == "--multipv" && i + 1 < argc) {
+			multiPV = std::max(1, std::atoi(argv[++i]));
+		}
+		else {
+			std::cerr << "Usage: ucibench [--engine PATH] [--iterations N] [--multipv N]" << std::endl;
+			return 2;
+		}
+	}
+
+	Stockfish engine(enginePath);
+	if (!engine.isRunning()) {
+		std::cerr << "Could not start " << enginePath << std::endl;
+		return 1;
+	}
+	engine.newGame();
+
+	const std::string fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+	std::vector<double> latenciesUs;
+	latenciesUs.reserve(iterations);
+
+	for (int i = 0; i < iterations; ++i) {
+		auto start = std::chrono::steady_clock::now();
+		std::vector<std::string> moves = engine.getBestMoves(fen, multiPV);
+		auto elapsed = std::chrono::steady_clock::now() - start;
+
+		if (moves.empty()) {
+			std::cerr << "Engine returned no moves on iteration " << i << std::endl;
+			return 1;
+		}
+		latenciesUs.push_back(std::chrono::duration<double, std::micro>(elapsed).count());
+	}
+
+	std::sort(latenciesUs.begin(), latenciesUs.end());
+	double total = 0;
+	for (double latency : latenciesUs) total += latency;
+	auto percentile = [&](double p) {
+		return latenciesUs[std::min(latenciesUs.size() - 1, static_cast<size_t>(p * latenciesUs.size()))];
+	};
+
+	std::cout << iterations << " round trips, multipv " << multiPV << "\n"
+		<< "  mean " << total / iterations << " us\n"
+		<< "  min " << latenciesUs.front() << " us  p50 " << percentile(0.5)
+		<< " us  p99 " << percentile(0.99) << " us  max " << latenciesUs.back() << " us" << std::endl;
+	return 0;
+}